@@ -6,50 +6,189 @@
 #include "esp32_c3_utils/type_utils.h"
 
 #include "queue.h"
+#include "slot_bitmap.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include "esp_log.h"
 
 namespace esp32_c3::objects
 {
+    /// @brief Способ учёта свободных слотов буфера
+    enum class FreeSlotTracking
+    {
+        QUEUE, ///< Отдельная очередь FreeRTOS свободных индексов (блокирующее ожидание слота)
+        BITMAP ///< Атомарная битовая карта: один объект ядра на очередь, ожидание слота опросом
+    };
+
     /**
      * @brief Потокобезопасная буферизированная очередь фиксированного размера
-     * @tparam T Тип элементов очереди
+     * @tparam T Тип элементов очереди (допускаются перемещаемые и нетривиальные типы)
      * @tparam BufferSize Максимальный размер буфера
+     * @tparam Tracking Способ учёта свободных слотов
+     * @details Элементы живут в слотах буфера: объект создаётся в слоте при отправке
+     * и уничтожается при получении, поэтому захваченные ресурсы освобождаются сразу
      */
-    template <typename T, size_t BufferSize>
+    template <typename T, size_t BufferSize, FreeSlotTracking Tracking = FreeSlotTracking::QUEUE>
     class BufferedQueue
     {
+        struct QueueItem
+        {
+            size_t index; ///< Индекс элемента в буфере
+        };
+
+        /// @brief Неинициализированная память под один элемент
+        struct SlotStorage
+        {
+            alignas(T) std::byte data[sizeof(T)];
+        };
+
+        /// @brief Хранилище свободных индексов в зависимости от способа учёта
+        using FreeIndices = std::conditional_t<Tracking == FreeSlotTracking::QUEUE,
+                                               Queue<size_t>, SlotBitmap<BufferSize>>;
+
+        /// @brief Пустое хранилище (битовой карте не нужна отдельная память)
+        struct NoStorage
+        {
+        };
+
+        /// @brief Статическое хранилище свободных индексов в зависимости от способа учёта
+        using FreeIndicesStorage = std::conditional_t<Tracking == FreeSlotTracking::QUEUE,
+                                                      QueueStorage<size_t, BufferSize>, NoStorage>;
+
     public:
         /**
-         * @brief Конструктор
-         * @param queueLength Максимальное количество элементов в очереди
+         * @brief Статическое хранилище очереди (без выделения памяти в куче)
+         * @tparam QueueLength Максимальное количество элементов в очереди
+         * @details Объявленное как глобальный или статический объект, размещается в .bss
          */
-        explicit BufferedQueue(UBaseType_t queueLength) noexcept
-            : mQueue(queueLength),
-              mFreeIndices(BufferSize),
-              mBuffer(std::make_unique<T[]>(BufferSize))
+        template <UBaseType_t QueueLength>
+        struct Storage
         {
-            // Проверка успешности создания всех компонентов
-            mInitialized = mQueue.isValid() && mFreeIndices.isValid() && mBuffer;
+            QueueStorage<QueueItem, QueueLength> queue; ///< Хранилище основной очереди
+            FreeIndicesStorage freeIndices;             ///< Хранилище свободных индексов
+            std::array<SlotStorage, BufferSize> buffer; ///< Буфер данных
+        };
 
-            if (mInitialized)
+        /**
+         * @brief Слот буфера, выданный во временное пользование (без копирования данных)
+         * @details Производитель получает слот через acquire() и передаёт его потребителю через commit().
+         * Потребитель получает слот через peek() и возвращает его в пул через release().
+         * Если слот не был передан или возвращён явно, деструктор уничтожает элемент и возвращает
+         * слот в пул свободных.
+         */
+        class Slot
+        {
+        public:
+            Slot() noexcept = default;
+
+            ~Slot() noexcept
             {
-                // Инициализация свободных индексов
-                for (size_t i = 0; i < BufferSize; ++i)
+                if (mOwner) mOwner->releaseIndex(mIndex);
+            }
+
+            // Запрет копирования
+            Slot(const Slot&) = delete;
+            Slot& operator=(const Slot&) = delete;
+
+            // Поддержка перемещения
+            Slot(Slot&& other) noexcept :
+                mOwner(std::exchange(other.mOwner, nullptr)),
+                mIndex(other.mIndex)
+            {
+            }
+
+            Slot& operator=(Slot&& other) noexcept
+            {
+                if (this != &other)
                 {
-                    if (!mFreeIndices.send(i, 0))
-                    {
-                        mInitialized = false;
-                        break;
-                    }
+                    if (mOwner) mOwner->releaseIndex(mIndex);
+                    mOwner = std::exchange(other.mOwner, nullptr);
+                    mIndex = other.mIndex;
                 }
+                return *this;
             }
 
-            ESP_LOGD((utils::generateTag<BufferedQueue<T, BufferSize>>()),
-                     "BufferedQueue %s initialized (buffer size: %zu)",
-                     mInitialized ? "successfully" : "failed to", BufferSize);
+            /// @brief Проверка, что слот получен
+            explicit operator bool() const noexcept
+            {
+                return mOwner != nullptr;
+            }
+
+            /// @brief Ссылка на данные в буфере очереди
+            T& operator*() const noexcept
+            {
+                return mOwner->slotAt(mIndex);
+            }
+
+            /// @brief Указатель на данные в буфере очереди
+            T* operator->() const noexcept
+            {
+                return &mOwner->slotAt(mIndex);
+            }
+
+        private:
+            friend class BufferedQueue;
+
+            Slot(const BufferedQueue* owner, const size_t index) noexcept :
+                mOwner(owner),
+                mIndex(index)
+            {
+            }
+
+            /// @brief Отвязать слот от владельца без возврата в пул
+            size_t detach() noexcept
+            {
+                mOwner = nullptr;
+                return mIndex;
+            }
+
+            const BufferedQueue* mOwner = nullptr; ///< Очередь-владелец слота
+            size_t mIndex = 0;                     ///< Индекс слота в буфере
+        };
+
+        /**
+         * @brief Конструктор
+         * @param queueLength Максимальное количество элементов в очереди
+         */
+        explicit BufferedQueue(UBaseType_t queueLength) noexcept
+            : mQueue(queueLength),
+              mFreeIndices(makeFreeIndices(nullptr)),
+              mOwnedBuffer(std::make_unique<SlotStorage[]>(BufferSize)),
+              mBuffer(mOwnedBuffer.get())
+        {
+            init();
+        }
+
+        /**
+         * @brief Конструктор на статическом хранилище (без выделения памяти в куче)
+         * @tparam QueueLength Максимальное количество элементов в очереди
+         * @param storage Хранилище очереди (должно существовать дольше очереди)
+         */
+        template <UBaseType_t QueueLength>
+        explicit BufferedQueue(Storage<QueueLength>& storage) noexcept
+            : mQueue(storage.queue),
+              mFreeIndices(makeFreeIndices(&storage.freeIndices)),
+              mBuffer(storage.buffer.data())
+        {
+            init();
+        }
+
+        /// @brief Деструктор (уничтожает элементы, оставшиеся в очереди)
+        ~BufferedQueue() noexcept
+        {
+            clear();
         }
 
+        // Запрет копирования и перемещения (слоты ссылаются на буфер очереди)
+        BufferedQueue(const BufferedQueue&) = delete;
+        BufferedQueue& operator=(const BufferedQueue&) = delete;
+
         /**
          * @brief Проверка валидности очереди
          * @return true если все компоненты инициализированы успешно
@@ -65,7 +204,30 @@ namespace esp32_c3::objects
          * @param ticksToWait Время ожидания
          * @return true если успешно
          */
-        bool send(const T& item, TickType_t ticksToWait = portMAX_DELAY) noexcept
+        bool send(const T& item, const TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            return emplace(ticksToWait, item);
+        }
+
+        /**
+         * @brief Отправить элемент в очередь перемещением
+         * @param item Элемент для отправки
+         * @param ticksToWait Время ожидания
+         * @return true если успешно
+         */
+        bool send(T&& item, const TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            return emplace(ticksToWait, std::move(item));
+        }
+
+        /**
+         * @brief Создать элемент непосредственно в слоте буфера и отправить его
+         * @param ticksToWait Время ожидания
+         * @param args Аргументы конструктора T
+         * @return true если успешно
+         */
+        template <typename... Args>
+        bool emplace(const TickType_t ticksToWait, Args&&... args) noexcept
         {
             if (!mInitialized) return false;
 
@@ -76,61 +238,302 @@ namespace esp32_c3::objects
                 return false;
             }
 
-            // Копируем данные в буфер
-            mBuffer[index] = item;
+            // Создаём элемент в буфере
+            ::new(static_cast<void*>(mBuffer[index].data)) T(std::forward<Args>(args)...);
 
             // Отправляем индекс в очередь
             if (QueueItem qi{index}; !mQueue.send(qi, ticksToWait))
             {
                 ESP_LOGE((utils::generateTag<BufferedQueue<T, BufferSize>>()), "Failed to send item to queue");
-                returnFreeIndex(index);
+                releaseIndex(index);
                 return false;
             }
 
             return true;
         }
 
+        /**
+         * @brief Отправить элемент, вытесняя самый старый при переполнении (без ожидания)
+         * @param item Элемент для отправки
+         * @return true если элемент поставлен в очередь
+         * @details Если свободных слотов нет, слот самого старого элемента очереди используется
+         * повторно; если заполнена очередь индексов, самый старый элемент удаляется из неё.
+         * Каждый вытесненный элемент учитывается в статистике как потерянный.
+         * Ошибка возможна только когда все слоты удерживаются потребителями через peek().
+         */
+        bool overwrite(const T& item) noexcept
+        {
+            return overwriteWith(item);
+        }
+
+        /**
+         * @brief Отправить элемент перемещением, вытесняя самый старый при переполнении (без ожидания)
+         * @param item Элемент для отправки
+         * @return true если элемент поставлен в очередь
+         */
+        bool overwrite(T&& item) noexcept
+        {
+            return overwriteWith(std::move(item));
+        }
+
+        /**
+         * @brief Отправить элемент из обработчика прерывания
+         * @param item Элемент для отправки
+         * @param higherPriorityTaskWoken Флаг переключения контекста (только устанавливается, не сбрасывается)
+         * @return true если успешно
+         * @note Переключение контекста не выполняется: вызовите portYIELD_FROM_ISR или используйте IsrYield
+         */
+        bool sendFromISR(const T& item, BaseType_t& higherPriorityTaskWoken) noexcept
+        {
+            if (!mInitialized) return false;
+
+            size_t index;
+            if (!mFreeIndices.receiveFromISR(index, higherPriorityTaskWoken))
+            {
+                mQueue.recordDrop();
+                return false;
+            }
+
+            ::new(static_cast<void*>(mBuffer[index].data)) T(item);
+            return commitIndexFromISR(index, higherPriorityTaskWoken);
+        }
+
         /**
          * @brief Получить элемент из очереди
-         * @param item Ссылка для сохранения элемента
+         * @param item Ссылка для сохранения элемента (присваивается перемещением)
          * @param ticksToWait Время ожидания
          * @return true если успешно
          */
         bool receive(T& item, TickType_t ticksToWait = portMAX_DELAY) noexcept
         {
-            if (!mInitialized) return false;
+            size_t index;
+            if (!receiveIndex(index, ticksToWait)) return false;
+
+            // Перемещаем данные из буфера, уничтожаем элемент и возвращаем индекс в пул
+            item = std::move(slotAt(index));
+            releaseIndex(index);
+            return true;
+        }
+
+        /**
+         * @brief Отправить несколько элементов в очередь
+         * @param items Элементы для отправки (в порядке следования)
+         * @param ticksToWait Время ожидания для каждого элемента
+         * @return Количество отправленных элементов (отправка прекращается на первой ошибке)
+         * @details Элементы создаются в слотах как обычно (конструктор T может выполнять любой код),
+         * а их индексы публикуются группами через Queue::sendBatch(), поэтому потребитель
+         * просыпается один раз на группу
+         */
+        size_t sendBatch(const std::span<const T> items, const TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            if (!mInitialized) return 0;
+
+            std::array<QueueItem, BATCH_GROUP> group;
+            size_t grouped = 0;
+            size_t sent = 0;
 
-            switch (QueueItem qi; mQueue.receive(qi, ticksToWait))
+            // Неопубликованные элементы уничтожаются, их слоты возвращаются в пул
+            const auto publish = [&]
             {
-            case QueueReceiveResult::SUCCESS:
-                // Копируем данные из буфера и возвращаем индекс в пул
-                item = mBuffer[qi.index];
-                returnFreeIndex(qi.index);
-                return true;
+                const size_t published = mQueue.sendBatch(std::span<const QueueItem>(group.data(), grouped),
+                                                          ticksToWait);
+                for (size_t i = published; i < grouped; ++i) releaseIndex(group[i].index);
+                sent += published;
+                const bool complete = published == grouped;
+                grouped = 0;
+                return complete;
+            };
 
-            case QueueReceiveResult::ABORTED:
-                ESP_LOGD((utils::generateTag<BufferedQueue<T, BufferSize>>()), "Receive operation aborted");
-                break;
+            for (const T& item : items)
+            {
+                // Слоты освобождает только потребитель, поэтому перед ожиданием слота
+                // собранные элементы должны стать ему видны
+                size_t index;
+                if (mFreeIndices.receive(index, 0) != QueueReceiveResult::SUCCESS)
+                {
+                    if (grouped > 0 && !publish()) return sent;
+                    if (!getFreeIndex(index, ticksToWait)) return sent;
+                }
 
-            case QueueReceiveResult::TIMEOUT:
-                ESP_LOGD((utils::generateTag<BufferedQueue<T, BufferSize>>()), "Receive operation timeout");
-                break;
+                ::new(static_cast<void*>(mBuffer[index].data)) T(item);
+                group[grouped++] = QueueItem{index};
+                if (grouped == group.size() && !publish()) return sent;
+            }
 
-            case QueueReceiveResult::QUEUE_ERROR:
-                ESP_LOGE((utils::generateTag<BufferedQueue<T, BufferSize>>()), "Queue error");
-                break;
-            default: ;
+            if (grouped > 0) publish();
+            return sent;
+        }
+
+        /**
+         * @brief Получить несколько элементов за одно пробуждение
+         * @param items Буфер для сохранения элементов
+         * @param minCount Минимальное количество элементов, которое ожидается в пределах ticksToWait
+         * @param ticksToWait Общее время ожидания первых minCount элементов
+         * @return Количество полученных элементов
+         * @note После получения minCount элементов забираются все уже доступные элементы
+         * (до размера буфера) без дополнительного ожидания
+         */
+        [[nodiscard]] size_t receiveBatch(const std::span<T> items,
+                                          const size_t minCount = 1,
+                                          TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            TimeOut_t timeOut;
+            vTaskSetTimeOutState(&timeOut);
+
+            size_t received = 0;
+            while (received < items.size())
+            {
+                const bool mustWait = received < minCount;
+                if (mustWait && received > 0 && xTaskCheckForTimeOut(&timeOut, &ticksToWait) != pdFALSE)
+                {
+                    break;
+                }
+
+                if (!receive(items[received], mustWait ? ticksToWait : 0)) break;
+                ++received;
+            }
+            return received;
+        }
+
+        /**
+         * @brief Обработать все доступные элементы за одно пробуждение без копирования
+         * @tparam F Тип обработчика, вызываемого как func(const T&) со ссылкой на слот буфера
+         * @param func Обработчик элементов
+         * @param ticksToWait Время ожидания первого элемента
+         * @return Количество обработанных элементов
+         * @note Обрабатываются только элементы, находившиеся в очереди на момент получения первого
+         */
+        template <typename F>
+        size_t drain(F&& func, const TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            size_t index;
+            if (!receiveIndex(index, ticksToWait)) return 0;
+
+            size_t count = 0;
+            UBaseType_t pending = mQueue.messagesWaiting();
+            do
+            {
+                func(static_cast<const T&>(slotAt(index)));
+                releaseIndex(index);
+                ++count;
+            }
+            while (pending-- > 0 && receiveIndex(index, 0));
+            return count;
+        }
+
+        /**
+         * @brief Занять свободный слот буфера для заполнения на месте (без копирования)
+         * @param ticksToWait Время ожидания свободного слота
+         * @return Слот для записи (пустой при ошибке или таймауте)
+         * @note Элемент в слоте создаётся инициализацией по умолчанию (для тривиальных типов
+         * содержимое не определено и должно быть заполнено)
+         */
+        [[nodiscard]] Slot acquire(TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            size_t index;
+            if (!getFreeIndex(index, ticksToWait))
+            {
+                ESP_LOGW((utils::generateTag<BufferedQueue<T, BufferSize>>()), "Failed to get free index");
+                return {};
+            }
+
+            ::new(static_cast<void*>(mBuffer[index].data)) T;
+            return {this, index};
+        }
+
+        /**
+         * @brief Передать заполненный слот потребителю
+         * @param slot Слот, полученный через acquire()
+         * @param ticksToWait Время ожидания места в очереди
+         * @return true если успешно (при ошибке слот остаётся у вызывающего)
+         */
+        bool commit(Slot& slot, TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            if (!mInitialized || slot.mOwner != this) return false;
+
+            if (QueueItem qi{slot.mIndex}; !mQueue.send(qi, ticksToWait))
+            {
+                ESP_LOGE((utils::generateTag<BufferedQueue<T, BufferSize>>()), "Failed to send item to queue");
+                return false;
+            }
+
+            (void)slot.detach();
+            return true;
+        }
+
+        /**
+         * @brief Занять свободный слот из обработчика прерывания
+         * @param higherPriorityTaskWoken Флаг переключения контекста (только устанавливается, не сбрасывается)
+         * @return Слот для записи (пустой, если свободных слотов нет)
+         * @warning Слот должен быть передан через commitFromISR() в том же обработчике:
+         * деструктор Slot использует функции, недопустимые в прерывании
+         */
+        [[nodiscard]] Slot acquireFromISR(BaseType_t& higherPriorityTaskWoken) noexcept
+        {
+            if (!mInitialized) return {};
+
+            if (size_t index; mFreeIndices.receiveFromISR(index, higherPriorityTaskWoken))
+            {
+                ::new(static_cast<void*>(mBuffer[index].data)) T;
+                return {this, index};
+            }
+            mQueue.recordDrop();
+            return {};
+        }
+
+        /**
+         * @brief Передать заполненный слот потребителю из обработчика прерывания
+         * @param slot Слот, полученный через acquireFromISR()
+         * @param higherPriorityTaskWoken Флаг переключения контекста (только устанавливается, не сбрасывается)
+         * @return true если успешно (при ошибке элемент уничтожается, а слот возвращается в пул свободных)
+         */
+        bool commitFromISR(Slot& slot, BaseType_t& higherPriorityTaskWoken) noexcept
+        {
+            if (!mInitialized || slot.mOwner != this) return false;
+            return commitIndexFromISR(slot.detach(), higherPriorityTaskWoken);
+        }
+
+        /**
+         * @brief Получить слот с данными без копирования
+         * @param ticksToWait Время ожидания
+         * @return Слот для чтения (пустой при ошибке, таймауте или прерывании)
+         * @note Слот возвращается в пул только после release() или уничтожения объекта Slot
+         */
+        [[nodiscard]] Slot peek(TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            size_t index;
+            if (!receiveIndex(index, ticksToWait)) return {};
+            return {this, index};
+        }
+
+        /**
+         * @brief Уничтожить элемент прочитанного слота и вернуть слот в пул свободных
+         * @param slot Слот, полученный через peek()
+         */
+        void release(Slot& slot) noexcept
+        {
+            if (slot.mOwner == this)
+            {
+                releaseIndex(slot.detach());
             }
-            return false;
         }
 
         /**
          * @brief Прервать блокирующую операцию receive и очистить очередь
          * @return true если успешно
+         * @note Очередь очищает получатель, прерванный сбросом: элементы уничтожаются,
+         * а их слоты возвращаются в пул. Без ожидающего получателя очистку выполнит
+         * следующий вызов receive (он вернёт false)
          */
         bool reset() const noexcept
         {
-            return mInitialized && mQueue.reset();
+            if (!mInitialized) return false;
+
+            mAbortFlag.store(true);
+
+            // Маркер будит получателя, заблокированного на пустой очереди; в непустой очереди
+            // он не нужен: получатель не блокируется и увидит флаг на ближайшем элементе
+            return mQueue.send(QueueItem{ABORT_MARKER}, 0) || mQueue.spacesAvailable() == 0;
         }
 
         /// @brief Количество свободных мест в очереди
@@ -145,6 +548,51 @@ namespace esp32_c3::objects
             return mInitialized ? mQueue.messagesWaiting() : 0;
         }
 
+        /**
+         * @brief Зарегистрировать очередь в реестре статистики
+         * @param name Имя очереди (должно быть статической строкой)
+         * @note Без ENABLE_QUEUE_STATS ничего не делает
+         */
+        void registerStats(const char* name) noexcept
+        {
+            mQueue.registerStats(name);
+        }
+
+        /**
+         * @brief Получить снимок статистики очереди
+         * @param reset Обнулить счётчики после снятия снимка
+         * @return Снимок статистики (dropped включает нехватку свободных слотов буфера)
+         */
+        [[nodiscard]] QueueStatsSnapshot stats(const bool reset = false) const noexcept
+        {
+            return mQueue.stats(reset);
+        }
+
+        /// @brief Хэндл очереди индексов FreeRTOS (для QueueSet)
+        [[nodiscard]] QueueHandle_t handle() const noexcept
+        {
+            return mQueue.handle();
+        }
+
+        /**
+         * @brief Установить обработчик успешной отправки (см. Queue::attachSendHook)
+         * @param hook Обработчик (должен существовать, пока установлен)
+         * @return true если установлен этот обработчик
+         */
+        bool attachSendHook(const QueueSendHook& hook) const noexcept
+        {
+            return mQueue.attachSendHook(hook);
+        }
+
+        /**
+         * @brief Снять обработчик успешной отправки
+         * @param hook Обработчик, установленный attachSendHook()
+         */
+        void detachSendHook(const QueueSendHook& hook) const noexcept
+        {
+            mQueue.detachSendHook(hook);
+        }
+
         /**
          * @brief Проверка, пуста ли очередь
          * @return true если очередь пуста или не инициализирована
@@ -155,14 +603,208 @@ namespace esp32_c3::objects
         }
 
     private:
-        struct QueueItem
+        /// @brief Элемент в слоте буфера
+        T& slotAt(const size_t index) const noexcept
         {
-            size_t index; ///< Индекс элемента в буфере
-        };
+            return *std::launder(reinterpret_cast<T*>(mBuffer[index].data));
+        }
+
+        /// @brief Уничтожить элемент слота и вернуть слот в пул свободных
+        void releaseIndex(const size_t index) const noexcept
+        {
+            std::destroy_at(&slotAt(index));
+            returnFreeIndex(index);
+        }
+
+        /// @brief Индекс маркера прерывания (не соответствует ни одному слоту)
+        static constexpr size_t ABORT_MARKER = BufferSize;
+
+        /// @brief Наибольшее количество индексов, публикуемых sendBatch() за один раз
+        static constexpr size_t BATCH_GROUP = BufferSize < 16 ? BufferSize : 16;
+
+        /// @brief Уничтожить все элементы, ожидающие в очереди
+        void clear() const noexcept
+        {
+            if (!mInitialized) return;
+
+            for (size_t index; takeOldest(index);)
+            {
+                releaseIndex(index);
+            }
+        }
+
+        /**
+         * @brief Отправить элемент, вытесняя самый старый при переполнении
+         * @param item Элемент для отправки (копируется или перемещается)
+         * @return true если элемент поставлен в очередь
+         */
+        template <typename U>
+        bool overwriteWith(U&& item) noexcept
+        {
+            if (!mInitialized) return false;
+
+            size_t index;
+            if (mFreeIndices.receive(index, 0) != QueueReceiveResult::SUCCESS)
+            {
+                // Свободных слотов нет: забираем слот самого старого элемента
+                if (!takeOldest(index)) return false;
+                std::destroy_at(&slotAt(index));
+                mQueue.recordDrop();
+            }
+
+            ::new(static_cast<void*>(mBuffer[index].data)) T(std::forward<U>(item));
+
+            if (QueueItem qi{index}; !mQueue.send(qi, 0))
+            {
+                // Очередь индексов заполнена: освобождаем место, вытесняя самый старый элемент
+                if (size_t oldest; takeOldest(oldest))
+                {
+                    releaseIndex(oldest);
+                    mQueue.recordDrop();
+                }
+
+                if (!mQueue.send(qi, 0))
+                {
+                    releaseIndex(index);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Отправить индекс заполненного слота из обработчика прерывания
+         * @param index Индекс слота с созданным элементом
+         * @param higherPriorityTaskWoken Флаг переключения контекста
+         * @return true если успешно (при ошибке элемент уничтожается, слот возвращается в пул)
+         */
+        bool commitIndexFromISR(const size_t index, BaseType_t& higherPriorityTaskWoken) const noexcept
+        {
+            if (QueueItem qi{index}; !mQueue.sendFromISR(qi, higherPriorityTaskWoken))
+            {
+                std::destroy_at(&slotAt(index));
+                (void)mFreeIndices.sendFromISR(index, higherPriorityTaskWoken);
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Проверка созданных компонентов и заполнение пула свободных индексов
+         */
+        void init() noexcept
+        {
+            // Проверка успешности создания всех компонентов
+            mInitialized = mQueue.isValid() && mFreeIndices.isValid() && mBuffer;
+
+            // Битовая карта создаётся заполненной, очередь индексов заполняется явно
+            if (Tracking == FreeSlotTracking::QUEUE && mInitialized)
+            {
+                // Инициализация свободных индексов
+                for (size_t i = 0; i < BufferSize; ++i)
+                {
+                    if (!mFreeIndices.send(i, 0))
+                    {
+                        mInitialized = false;
+                        break;
+                    }
+                }
+            }
+
+            ESP_LOGD((utils::generateTag<BufferedQueue<T, BufferSize>>()),
+                     "BufferedQueue %s initialized (buffer size: %zu)",
+                     mInitialized ? "successfully" : "failed to", BufferSize);
+        }
+
+        /**
+         * @brief Получить индекс заполненного слота из основной очереди
+         * @param index Ссылка для сохранения индекса
+         * @param ticksToWait Время ожидания
+         * @return true если успешно
+         */
+        bool receiveIndex(size_t& index, const TickType_t ticksToWait) const noexcept
+        {
+            if (!mInitialized) return false;
+
+            QueueItem qi;
+            const QueueReceiveResult result = mQueue.receive(qi, ticksToWait);
+
+            // Прерывание обрабатывается здесь, а не очисткой очереди FreeRTOS: xQueueReset
+            // потерял бы индексы, отправленные после сброса, вместе с их слотами
+            if (mAbortFlag.exchange(false))
+            {
+                if (result == QueueReceiveResult::SUCCESS && qi.index != ABORT_MARKER)
+                {
+                    releaseIndex(qi.index);
+                }
+                clear();
+                ESP_LOGD((utils::generateTag<BufferedQueue<T, BufferSize>>()), "Receive operation aborted");
+                return false;
+            }
+
+            switch (result)
+            {
+            case QueueReceiveResult::SUCCESS:
+                // Маркер прерывания, флаг которого уже обработан другим получателем
+                if (qi.index == ABORT_MARKER) return false;
+                index = qi.index;
+                return true;
+
+            case QueueReceiveResult::ABORTED:
+                ESP_LOGD((utils::generateTag<BufferedQueue<T, BufferSize>>()), "Receive operation aborted");
+                break;
+
+            case QueueReceiveResult::TIMEOUT:
+                ESP_LOGD((utils::generateTag<BufferedQueue<T, BufferSize>>()), "Receive operation timeout");
+                break;
+
+            case QueueReceiveResult::QUEUE_ERROR:
+                ESP_LOGE((utils::generateTag<BufferedQueue<T, BufferSize>>()), "Queue error");
+                break;
+            default: ;
+            }
+            return false;
+        }
+
+        static FreeIndices makeFreeIndices(FreeIndicesStorage* storage) noexcept
+        {
+            if constexpr (Tracking == FreeSlotTracking::QUEUE)
+            {
+                return storage ? FreeIndices(*storage) : FreeIndices(BufferSize);
+            }
+            else
+            {
+                return FreeIndices();
+            }
+        }
+
+        /**
+         * @brief Забрать из очереди индекс самого старого элемента без ожидания
+         * @param index Ссылка для сохранения индекса
+         * @return true если очередь не пуста
+         */
+        bool takeOldest(size_t& index) const noexcept
+        {
+            for (QueueItem qi; mQueue.receive(qi, 0) == QueueReceiveResult::SUCCESS;)
+            {
+                // Маркеры прерывания не занимают слотов и просто отбрасываются
+                if (qi.index == ABORT_MARKER) continue;
+                index = qi.index;
+                return true;
+            }
+            return false;
+        }
 
         bool getFreeIndex(size_t& index, const TickType_t ticksToWait) const noexcept
         {
-            return mInitialized && mFreeIndices.receive(index, ticksToWait) == QueueReceiveResult::SUCCESS;
+            if (!mInitialized) return false;
+
+            if (mFreeIndices.receive(index, ticksToWait) != QueueReceiveResult::SUCCESS)
+            {
+                mQueue.recordDrop();
+                return false;
+            }
+            return true;
         }
 
         void returnFreeIndex(const size_t index) const noexcept
@@ -173,10 +815,49 @@ namespace esp32_c3::objects
             }
         }
 
-        Queue<QueueItem> mQueue;      ///< Основная очередь
-        Queue<size_t> mFreeIndices;   ///< Очередь свободных индексов
-        std::unique_ptr<T[]> mBuffer; ///< Буфер данных
-        bool mInitialized = false;    ///< Флаг успешной инициализации
+        Queue<QueueItem> mQueue;                     ///< Основная очередь
+        FreeIndices mFreeIndices;                    ///< Свободные индексы (очередь или битовая карта)
+        std::unique_ptr<SlotStorage[]> mOwnedBuffer; ///< Буфер данных в куче (если не задано статическое хранилище)
+        SlotStorage* mBuffer = nullptr;              ///< Буфер данных
+        bool mInitialized = false;                   ///< Флаг успешной инициализации
+        mutable std::atomic<bool> mAbortFlag{false}; ///< Запрошено прерывание receive (reset)
+    };
+
+    /**
+     * @brief Почтовый ящик: хранит только последнее отправленное значение
+     * @tparam T Тип значения
+     * @details Очередь индексов длиной 1 и два слота буфера: post() всегда успешно заменяет
+     * непрочитанное значение, даже пока потребитель копирует предыдущее.
+     * Подходит для часто обновляемых снимков состояния, где важна только актуальная версия.
+     */
+    template <typename T, FreeSlotTracking Tracking = FreeSlotTracking::QUEUE>
+    class Mailbox : public BufferedQueue<T, 2, Tracking>
+    {
+    public:
+        Mailbox() noexcept :
+            BufferedQueue<T, 2, Tracking>(1)
+        {
+        }
+
+        /**
+         * @brief Опубликовать новое значение, заменив непрочитанное
+         * @param value Новое значение
+         * @return true если успешно
+         */
+        bool post(const T& value) noexcept
+        {
+            return this->overwrite(value);
+        }
+
+        /**
+         * @brief Опубликовать новое значение перемещением, заменив непрочитанное
+         * @param value Новое значение
+         * @return true если успешно
+         */
+        bool post(T&& value) noexcept
+        {
+            return this->overwrite(std::move(value));
+        }
     };
 } // namespace esp32_c3::objects
 
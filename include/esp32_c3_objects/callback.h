@@ -3,32 +3,58 @@
 
 #include "thread.h"
 #include "buffered_queue.h"
+#include "completion.h"
+#include "handler_stats.h"
+#include "esp32_c3_utils/inplace_function.h"
 #include "esp32_c3_utils/type_utils.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
 #include <mutex>
 #include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 #include <functional>
+#include <freertos/semphr.h>
 #include <esp_log.h>
 
 namespace esp32_c3::objects
 {
+    /// @brief Ёмкость буфера заданий Callback по умолчанию
+    constexpr uint8_t CALLBACK_DEFAULT_BUFFER_SIZE = 5;
+
     /**
      * @brief Типизированный менеджер callback-функций
      * @tparam T Тип передаваемых данных
+     * @tparam FunctionCapacity Ёмкость utils::InplaceFunction для callback- и response-функций
+     * (0 - использовать std::function)
+     * @tparam BufferCapacity Количество слотов буфера заданий (больший bufferSize - ошибка конструктора)
+     * @tparam Lanes Количество уровней приоритета событий (1-4, у каждого своя очередь)
+     * @details Таблица функций заполняется только добавлением в конец, поэтому рабочий поток
+     * читает опубликованный снимок (версия и количество функций в одном атомарном слове)
+     * без блокировок и копирования: опубликованные элементы не изменяются до free().
      */
-    template <typename T>
+    template <typename T,
+              size_t FunctionCapacity = 0,
+              uint8_t BufferCapacity = CALLBACK_DEFAULT_BUFFER_SIZE,
+              uint8_t Lanes = 1>
     class Callback
     {
         static_assert(std::is_trivially_copyable_v<T>,
                       "Type T must be trivially copyable");
+        static_assert(BufferCapacity > 0, "Buffer capacity must be greater than zero");
+        static_assert(Lanes >= 1 && Lanes <= 4, "Number of priority lanes must be between 1 and 4");
 
     public:
         /// @brief Количество callback-функций по умолчанию
         static constexpr uint8_t DEFAULT_CALLBACKS = 10;
 
         /// @brief Размер буфера данных по умолчанию
-        static constexpr uint8_t DEFAULT_BUFFER_SIZE = 5;
+        static constexpr uint8_t DEFAULT_BUFFER_SIZE = BufferCapacity;
 
         /// @brief Размер стека задачи по умолчанию (в байтах)
         static constexpr uint32_t DEFAULT_STACK_DEPTH = 3072;
@@ -36,19 +62,161 @@ namespace esp32_c3::objects
         /// @brief Приоритет задачи по умолчанию
         static constexpr UBaseType_t DEFAULT_PRIORITY = 18;
 
+        /// @brief Число подряд обработанных событий старшего уровня, после которого
+        /// обслуживается ожидающий младший уровень (защита от голодания)
+        static constexpr uint8_t DEFAULT_STARVATION_BUDGET = 8;
+
         /**
          * @brief Тип callback-функции (лямбда)
          * @param input Входные данные (read-only)
          * @param output Буфер для результата (может быть nullptr)
          * @return true если нужно вернуть output
          */
-        using CallbackFunction = std::function<bool(const T& input, T& output)>;
+        using CallbackFunction = std::conditional_t<FunctionCapacity == 0,
+                                                    std::function<bool(const T& input, T& output)>,
+                                                    utils::InplaceFunction<bool(const T& input, T& output),
+                                                                           FunctionCapacity>>;
 
         /**
          * @brief Тип response-функции для возврата результата
          * @param result Результат обработки данных
          */
-        using ResponseFunction = std::function<void(const T& result)>;
+        using ResponseFunction = std::conditional_t<FunctionCapacity == 0,
+                                                    std::function<void(const T& result)>,
+                                                    utils::InplaceFunction<void(const T& result),
+                                                                           FunctionCapacity>>;
+
+        /**
+         * @brief Тип функции извлечения ключа для объединения событий
+         * @param input Входные данные события
+         * @return Ключ: события с одинаковым ключом и индексом считаются повторами
+         */
+        using KeyExtractor = uint32_t (*)(const T& input);
+
+        /**
+         * @brief Асинхронный результат вызова invokeAsync()
+         * @details Хранится у вызывающего (обычно на стеке), поэтому вызов не выделяет память.
+         * Worker-поток записывает результат прямо в объект и будит ожидающую задачу
+         * прямым уведомлением (см. Completion).
+         * @note Объект нельзя перемещать, пока обработка не завершена. Деструктор отменяет
+         * ещё не начатую обработку (задание остаётся в очереди, но к объекту больше не обращается)
+         * или дожидается завершения уже начатой.
+         */
+        class Future : public Completion
+        {
+        public:
+            Future() noexcept = default;
+
+            ~Future() noexcept
+            {
+                // Результат уничтожается раньше базового класса, поэтому обработка завершается здесь
+                cancelOrJoin();
+            }
+
+            /**
+             * @brief Дождаться результата
+             * @param ticksToWait Время ожидания
+             * @return Результат первой callback-функции, вернувшей true, либо std::nullopt
+             * (истекло время ожидания, вызов отменён или ни одна функция не вернула результат)
+             * @note Задание, удалённое из очереди вызовом free() или деструктором менеджера,
+             * отменяется: ожидание завершается с std::nullopt
+             */
+            [[nodiscard]] std::optional<T> wait(const TickType_t ticksToWait = portMAX_DELAY) noexcept
+            {
+                if (!Completion::wait(ticksToWait)) return std::nullopt;
+                return mResult;
+            }
+
+        private:
+            friend class Callback;
+
+            /// @brief Подготовка к новому вызову (false если предыдущий ещё не завершён)
+            bool arm() noexcept
+            {
+                if (!Completion::arm()) return false;
+                mResult.reset();
+                return true;
+            }
+
+            std::optional<T> mResult; ///< Результат обработки
+        };
+
+    protected:
+        /**
+         * @brief Структура элемента callback
+         */
+        struct Item
+        {
+            bool onlyIndex;        ///< Флаг вызова только по индексу
+            CallbackFunction func; ///< Лямбда-функция
+
+            [[no_unique_address]] HandlerStatsType stats{}; ///< Статистика выполнения
+        };
+
+        /**
+         * @brief Структура элемента задачи
+         */
+        struct TaskItem
+        {
+            int16_t itemIndex;               ///< Индекс callback (-1 для всех)
+            T data;                          ///< Передаваемые данные
+            ResponseFunction response;       ///< Функция для возврата результата
+            CompletionTicket future{};       ///< Ссылка на асинхронный результат (для invokeAsync)
+            int16_t coalesceSlot = -1;       ///< Запись таблицы объединения (-1 если не используется)
+            uint16_t coalesceGeneration = 0; ///< Поколение таблицы объединения при постановке
+        };
+
+        /**
+         * @brief Запись таблицы объединения событий
+         */
+        struct CoalesceEntry
+        {
+            uint32_t key = 0;        ///< Ключ события
+            int16_t itemIndex = 0;   ///< Индекс callback события
+            bool used = false;       ///< Запись занята
+            bool pending = false;    ///< Событие с этим ключом ожидает в очереди
+            TickType_t accepted = 0; ///< Время постановки последнего события в очередь
+            T data{};                ///< Актуальные данные ожидающего события
+        };
+
+        /// @brief Тип очереди заданий
+        using TaskQueue = BufferedQueue<TaskItem, BufferCapacity>;
+
+        /**
+         * @brief Очерёдность обработки событий одного индекса в режиме пула
+         */
+        struct IndexOrder
+        {
+            uint32_t next = 0;    ///< Следующий номер (выдаётся под mDequeueMutex)
+            uint32_t serving = 0; ///< Номер, разрешённый к обработке (под mOrderMutex)
+        };
+
+        /// @brief Индекс служебного задания, завершающего рабочий поток пула
+        static constexpr int16_t STOP_INDEX = INT16_MIN;
+
+    public:
+        /**
+         * @brief Статическое хранилище менеджера (без выделения памяти в куче)
+         * @tparam NumCallbacks Максимальное количество callback-функций
+         * @tparam StackDepth Размер стека задачи в байтах
+         * @tparam QueueLength Количество элементов в очереди заданий
+         * @details Объявленное как глобальный или статический объект, размещается в .bss
+         */
+        template <uint8_t NumCallbacks,
+                  uint32_t StackDepth = DEFAULT_STACK_DEPTH,
+                  UBaseType_t QueueLength = DEFAULT_BUFFER_SIZE>
+        struct Storage
+        {
+            static_assert(NumCallbacks > 0, "Number of callbacks must be greater than zero");
+            static_assert(QueueLength <= BufferCapacity, "Queue length must not exceed the buffer capacity");
+
+            ThreadStorage<StackDepth> thread;                        ///< Стек и TCB рабочего потока
+            typename TaskQueue::template Storage<QueueLength> queue; ///< Хранилище очереди заданий
+            std::array<Item, NumCallbacks> items;                    ///< Массив callback-функций
+
+            /// Хранилища очередей старших уровней приоритета
+            std::array<typename TaskQueue::template Storage<QueueLength>, Lanes - 1> lanes;
+        };
 
         /**
          * @brief Конструктор менеджера callback-функций
@@ -57,39 +225,77 @@ namespace esp32_c3::objects
          * @param name Имя задачи для отладки (должно быть статической строкой)
          * @param stackDepth Размер стека задачи в байтах (по умолчанию 3072)
          * @param priority Приоритет задачи FreeRTOS (по умолчанию 18)
+         * @param workers Количество рабочих потоков, читающих общую очередь (по умолчанию 1)
          *
          * @note Особенности работы:
          * - Выделяет память под буферы сразу в конструкторе
          * - Автоматически запускает worker-поток
-         * - При ошибках выделения памяти объект остаётся неработоспособным (isInitialized() = false)
+         * - При ошибках выделения памяти или bufferSize больше BufferCapacity объект остаётся
+         *   неработоспособным (isInitialized() = false)
+         * - При workers > 1 события, адресованные одному индексу, обрабатываются строго по очереди,
+         *   а функции без onlyIndex могут вызываться из нескольких потоков одновременно
+         * - При Lanes > 1 каждый уровень приоритета получает очередь длиной bufferSize
          */
         explicit Callback(const char* name,
                           uint8_t bufferSize = DEFAULT_BUFFER_SIZE,
                           uint8_t numCallbacks = DEFAULT_CALLBACKS,
                           const uint32_t stackDepth = DEFAULT_STACK_DEPTH,
-                          const UBaseType_t priority = DEFAULT_PRIORITY) noexcept :
+                          const UBaseType_t priority = DEFAULT_PRIORITY,
+                          const uint8_t workers = 1) noexcept :
             mThread(name, stackDepth, priority),
-            mQueue(bufferSize),
-            mItems(numCallbacks > 0 ? std::make_unique<Item[]>(numCallbacks) : nullptr),
+            mQueue(std::min(bufferSize, BufferCapacity)),
+            mOwnedItems(numCallbacks > 0 ? std::make_unique<Item[]>(numCallbacks) : nullptr),
+            mItems(mOwnedItems.get()),
             mNumItems(numCallbacks)
         {
-            if (mQueue.isValid() && numCallbacks > 0)
+            if (workers > 1)
             {
-                ESP_LOGI(utils::generateTag<Callback<T>>(), "Constructed with buffer size %d and %d callbacks",
-                         bufferSize, numCallbacks);
-                free();
+                mOrder = std::make_unique<IndexOrder[]>(numCallbacks);
+                mExtraWorkers.reserve(workers - 1);
+                for (uint8_t i = 1; i < workers; ++i)
+                {
+                    char workerName[THREAD_NAME_SIZE];
+                    std::snprintf(workerName, sizeof(workerName), "%s#%u", name, static_cast<unsigned>(i));
+                    mExtraWorkers.push_back(std::make_unique<Thread>(workerName, stackDepth, priority));
+                }
             }
-            else
+            for (auto& lane : mLanes) lane.emplace(std::min(bufferSize, BufferCapacity));
+            if (bufferSize > BufferCapacity)
             {
-                ESP_LOGE(utils::generateTag<Callback<T>>(), "Memory allocation failed");
+                // Урезанная очередь молча ломала бы расчёт вызывающего кода на длину пачки
+                ESP_LOGE((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "Buffer size %u exceeds capacity %u", static_cast<unsigned>(bufferSize),
+                         static_cast<unsigned>(BufferCapacity));
+                mBufferSizeValid = false;
+                return;
             }
+            init(bufferSize);
+        }
+
+        /**
+         * @brief Конструктор менеджера на статическом хранилище (без выделения памяти в куче)
+         * @param name Имя задачи для отладки (должно быть статической строкой)
+         * @param storage Хранилище потока, очереди и callback-функций (должно существовать дольше объекта)
+         * @param priority Приоритет задачи FreeRTOS (по умолчанию 18)
+         */
+        template <uint8_t NumCallbacks, uint32_t StackDepth, UBaseType_t QueueLength>
+        explicit Callback(const char* name,
+                          Storage<NumCallbacks, StackDepth, QueueLength>& storage,
+                          const UBaseType_t priority = DEFAULT_PRIORITY) noexcept :
+            mThread(name, storage.thread, priority),
+            mQueue(storage.queue),
+            mItems(storage.items.data()),
+            mNumItems(NumCallbacks)
+        {
+            for (size_t i = 0; i < mLanes.size(); ++i) mLanes[i].emplace(storage.lanes[i]);
+            init(QueueLength);
         }
 
         /// @brief Деструктор (освобождает ресурсы)
         ~Callback()
         {
             stopThread();
-            ESP_LOGI(utils::generateTag<Callback<T>>(), "Callback destroyed");
+            ESP_LOGI((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()), "Callback destroyed");
         }
 
         // Запрещаем копирование объектов
@@ -102,8 +308,20 @@ namespace esp32_c3::objects
          */
         [[nodiscard]] bool isInitialized() const noexcept
         {
-            std::lock_guard lock(mMutex);
-            return mQueue.isValid() && mItems;
+            if constexpr (Lanes > 1)
+            {
+                if (!mLaneSignal) return false;
+            }
+            return mBufferSizeValid && mQueue.isValid() && mItems;
+        }
+
+        /**
+         * @brief Версия опубликованной таблицы callback-функций
+         * @return Номер версии (увеличивается при каждом изменении таблицы)
+         */
+        [[nodiscard]] uint16_t version() const noexcept
+        {
+            return snapshotVersion(mSnapshot.load(std::memory_order_acquire));
         }
 
         /**
@@ -119,21 +337,22 @@ namespace esp32_c3::objects
 
             std::lock_guard lock(mMutex);
 
-            // Быстрый поиск начиная с последнего свободного индекса
-            for (int16_t i = 0; i < mNumItems; ++i)
+            const uint32_t snapshot = mSnapshot.load(std::memory_order_relaxed);
+            const uint16_t count = snapshotCount(snapshot);
+            if (count >= mNumItems)
             {
-                if (const int16_t currentIndex = (mLastFreeIndex + i) % mNumItems; !mItems[currentIndex].func)
-                {
-                    mItems[currentIndex] = {onlyIndex, std::move(func)};
-                    mLastFreeIndex = (currentIndex + 1) % mNumItems;
-
-                    ESP_LOGD(utils::generateTag<Callback<T>>(), "Added callback at index %d", currentIndex);
-                    return currentIndex;
-                }
+                ESP_LOGW((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "No free slots for callback");
+                return -1;
             }
 
-            ESP_LOGW(utils::generateTag<Callback<T>>(), "No free slots for callback");
-            return -1;
+            // Элемент за пределами снимка не виден рабочему потоку, его можно заполнять без синхронизации
+            mItems[count] = {onlyIndex, std::move(func)};
+            mSnapshot.store(makeSnapshot(snapshotVersion(snapshot) + 1, count + 1), std::memory_order_release);
+
+            ESP_LOGD((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                     "Added callback at index %d", count);
+            return static_cast<int16_t>(count);
         }
 
         /**
@@ -146,6 +365,8 @@ namespace esp32_c3::objects
                 stopThread();
 
                 std::lock_guard lock(mMutex);
+                const uint32_t snapshot = mSnapshot.load(std::memory_order_relaxed);
+                mSnapshot.store(makeSnapshot(snapshotVersion(snapshot) + 1, 0), std::memory_order_release);
                 if (mItems)
                 {
                     for (uint8_t i = 0; i < mNumItems; ++i)
@@ -153,8 +374,8 @@ namespace esp32_c3::objects
                         mItems[i] = {};
                     }
                 }
-                mLastFreeIndex = 0;
-                ESP_LOGD(utils::generateTag<Callback<T>>(), "Cleared all callbacks");
+                ESP_LOGD((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "Cleared all callbacks");
             }
         }
 
@@ -163,35 +384,201 @@ namespace esp32_c3::objects
          * @param input Входные данные (не изменяются)
          * @param response Лямбда-функция для обработки результата (опционально)
          * @param index Индекс callback (-1 для всех)
+         * @param lane Уровень приоритета (0 - низший, Lanes - 1 - высший)
          */
         void invoke(const T& input,
                     ResponseFunction response = nullptr,
-                    const int16_t index = -1) noexcept
+                    const int16_t index = -1,
+                    const uint8_t lane = 0) noexcept
         {
             if (!isInitialized())
             {
-                ESP_LOGE(utils::generateTag<Callback<T>>(), "Invoke failed: not initialized or null input");
+                ESP_LOGE((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "Invoke failed: not initialized or null input");
+                return;
+            }
+
+            int16_t slot = -1;
+            uint16_t generation = 0;
+            if (!admit(input, index, slot, generation)) return;
+
+            if (!enqueue(lane, TaskItem{index, input, std::move(response), {}, slot, generation}, portMAX_DELAY))
+            {
+                if (slot >= 0)
+                {
+                    T data;
+                    takeCoalesced(slot, generation, data);
+                }
+                ESP_LOGE((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "Failed to send item to queue");
+            }
+        }
+
+        /**
+         * @brief Включение объединения повторяющихся событий в invoke()
+         * @param extractor Функция извлечения ключа (nullptr - выключить объединение)
+         * @param windowMs Окно подавления дребезга в мс (0 - без подавления)
+         * @details Пока событие с тем же ключом и индексом ожидает в очереди, новый вызов
+         * только заменяет его данные (response остаётся от первого вызова). Если задано окно,
+         * события с тем же ключом, пришедшие в течение windowMs после последнего принятого,
+         * отбрасываются (подавление по переднему фронту).
+         * @note Объединение применяется только к invoke(); invokeAsync() и invokeAndWait()
+         * всегда ставят событие в очередь
+         * @note Вызов сбрасывает таблицу и увеличивает её поколение. События, уже ожидающие
+         * в очереди, обрабатываются со своими исходными данными: их записи принадлежат старому
+         * поколению и не смешиваются с записями новых ключей
+         */
+        void setCoalescing(const KeyExtractor extractor, const uint32_t windowMs = 0) noexcept
+        {
+            std::lock_guard lock(mCoalesceMutex);
+            mKeyExtractor = extractor;
+            mCoalesceWindow = pdMS_TO_TICKS(windowMs);
+            mCoalesce = {};
+            ++mCoalesceGeneration;
+        }
+
+        /**
+         * @brief Асинхронный вызов с результатом в Future (без выделения памяти)
+         * @param input Входные данные (не изменяются)
+         * @param future Объект для результата (при уничтожении отменяет ещё не начатую обработку)
+         * @param index Индекс callback (-1 для всех)
+         * @param ticksToWait Время ожидания места в очереди
+         * @param lane Уровень приоритета (0 - низший, Lanes - 1 - высший)
+         * @return true если задание поставлено в очередь (false также если ожидают обработки
+         * уже BufferCapacity * Lanes асинхронных вызовов)
+         */
+        bool invokeAsync(const T& input,
+                         Future& future,
+                         const int16_t index = -1,
+                         const TickType_t ticksToWait = portMAX_DELAY,
+                         const uint8_t lane = 0) noexcept
+        {
+            if (!isInitialized() || !future.arm()) return false;
+
+            CompletionTicket ticket;
+            if (!mCompletions.attach(future, ticket))
+            {
+                future.abandon();
+                ESP_LOGE((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "No free future slots");
+                return false;
+            }
+            if (!enqueue(lane, TaskItem{index, input, nullptr, ticket}, ticksToWait))
+            {
+                future.abandon();
+                ESP_LOGE((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "Failed to send item to queue");
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Синхронный вызов с ожиданием результата
+         * @param input Входные данные (не изменяются)
+         * @param ticksToWait Общее время ожидания (очередь и обработка)
+         * @param index Индекс callback (-1 для всех)
+         * @param lane Уровень приоритета (0 - низший, Lanes - 1 - высший)
+         * @return Результат первой callback-функции, вернувшей true, или std::nullopt
+         * @note Если по истечении времени обработка уже начата, вызов дожидается её завершения
+         * (worker-поток пишет результат в стек вызывающей задачи)
+         */
+        [[nodiscard]] std::optional<T> invokeAndWait(const T& input,
+                                                     TickType_t ticksToWait = portMAX_DELAY,
+                                                     const int16_t index = -1,
+                                                     const uint8_t lane = 0) noexcept
+        {
+            TimeOut_t timeOut;
+            vTaskSetTimeOutState(&timeOut);
+
+            Future future;
+            if (!invokeAsync(input, future, index, ticksToWait, lane)) return std::nullopt;
+
+            if (xTaskCheckForTimeOut(&timeOut, &ticksToWait) != pdFALSE) ticksToWait = 0;
+            return future.wait(ticksToWait);
+        }
+
+        /**
+         * @brief Установка защиты от голодания младших уровней приоритета
+         * @param budget Число подряд обработанных событий уровня, после которого обслуживается
+         * ожидающий младший уровень (0 - строгий приоритет без защиты)
+         */
+        void setStarvationBudget(const uint8_t budget) noexcept
+        {
+            mStarvationBudget.store(budget);
+        }
+
+        /**
+         * @brief Статистика выполнения callback-функций (при ENABLE_CALLBACK_PROFILING)
+         * @param out Буфер для снимков (элемент i соответствует функции с индексом i)
+         * @param reset Обнулить счётчики после снятия снимков
+         * @return Количество записанных снимков
+         */
+        size_t profile(const std::span<HandlerProfile> out, const bool reset = false) const noexcept
+        {
+            if (!mItems) return 0;
+
+            const size_t count = std::min<size_t>(snapshotCount(mSnapshot.load(std::memory_order_acquire)),
+                                                  out.size());
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = mItems[i].stats.snapshot(reset);
+            }
+            return count;
+        }
+
+        /**
+         * @brief Вывод статистики выполнения callback-функций в журнал
+         * @param reset Обнулить счётчики после вывода
+         */
+        void dumpProfile(const bool reset = false) const noexcept
+        {
+            if constexpr (!CALLBACK_PROFILING_ENABLED)
+            {
+                ESP_LOGW((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "Profiling disabled (define ENABLE_CALLBACK_PROFILING)");
                 return;
             }
 
-            if (TaskItem item{index, std::move(input), std::move(response)}; !mQueue.send(item))
+            if (!mItems) return;
+
+            const uint16_t count = snapshotCount(mSnapshot.load(std::memory_order_acquire));
+            for (uint16_t i = 0; i < count; ++i)
             {
-                ESP_LOGE(utils::generateTag<Callback<T>>(), "Failed to send item to queue");
+                const HandlerProfile p = mItems[i].stats.snapshot(reset);
+                ESP_LOGI((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "[%u] calls: %lu, avg: %lu, max: %lu cycles, slow: %lu",
+                         static_cast<unsigned>(i), (unsigned long)p.calls,
+                         (unsigned long)(p.calls ? p.totalCycles / p.calls : 0),
+                         (unsigned long)p.maxCycles, (unsigned long)p.slowCalls);
             }
         }
 
+        /**
+         * @brief Установка порога медленного вызова (при ENABLE_CALLBACK_PROFILING)
+         * @param cycles Порог в тактах процессора (0 - не проверять)
+         * @param log Выводить предупреждение о каждом превышении (иначе только подсчёт)
+         */
+        void setSlowThreshold(const uint32_t cycles, const bool log = true) noexcept
+        {
+            mSlowThreshold.store(cycles);
+            mLogSlow.store(log);
+        }
+
         /**
          * @brief Чтение данных из буфера
          * @param value Указатель на буфер для данных
          * @return true если данные успешно прочитаны
          */
-        [[nodiscard]] bool read(T& value) const noexcept
+        [[nodiscard]] bool read(T& value) noexcept
         {
             if (isInitialized())
             {
-                if (TaskItem item; const_cast<BufferedQueue<TaskItem, DEFAULT_BUFFER_SIZE>&>(mQueue).receive(item))
+                if (TaskItem item; mQueue.receive(item))
                 {
+                    // Запись объединения освобождается, иначе ключ события больше не попал бы в очередь
                     value = item.data;
+                    if (item.coalesceSlot >= 0) takeCoalesced(item.coalesceSlot, item.coalesceGeneration, value);
                     return true;
                 }
             }
@@ -200,97 +587,510 @@ namespace esp32_c3::objects
 
     protected:
         /**
-         * @brief Структура элемента callback
+         * @brief Проверка созданных компонентов и сброс таблицы callback-функций
+         * @param queueLength Количество элементов в очереди заданий (для журнала)
          */
-        struct Item
+        void init(const UBaseType_t queueLength) noexcept
         {
-            bool onlyIndex;        ///< Флаг вызова только по индексу
-            CallbackFunction func; ///< Лямбда-функция
-        };
+            if constexpr (Lanes > 1)
+            {
+                // Семафор размещается в самом объекте, поэтому уровни не выделяют память в куче.
+                // Запас ёмкости покрывает сигналы элементов, удалённых из очередей при остановке
+                const bool lanesValid = std::all_of(mLanes.begin(), mLanes.end(),
+                                                    [](const auto& lane) { return lane->isValid(); });
+                if (lanesValid)
+                {
+                    mLaneSignal = xSemaphoreCreateCountingStatic(2 * queueLength * Lanes, 0, &mLaneSignalBuffer);
+                }
+            }
+
+            if (isInitialized())
+            {
+                ESP_LOGI((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "Constructed with buffer size %u and %u callbacks",
+                         static_cast<unsigned>(queueLength), static_cast<unsigned>(mNumItems));
+                free();
+            }
+            else
+            {
+                ESP_LOGE((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "Memory allocation failed");
+            }
+        }
 
         /**
-         * @brief Структура элемента задачи
+         * @brief Остановка потока с гарантированным выходом
          */
-        struct TaskItem
+        void stopThread() noexcept
         {
-            int16_t itemIndex;         ///< Индекс callback (-1 для всех)
-            T data;                    ///< Передаваемые данные
-            ResponseFunction response; ///< Функция для возврата результата
-        };
+            if (mExtraWorkers.empty())
+            {
+                mStopRequested.store(true);
+                mQueue.reset();
+                signalLanes();
+                mThread.stop();
+            }
+            else
+            {
+                // Прерывание receive будит только один поток, поэтому каждому работающему потоку
+                // пула отправляется служебное задание; задания перед ним успевают обработаться.
+                // Служебное задание забирает любой поток, поэтому работающие потоки считаются
+                // до отправки: иначе поток, забравший чужое задание, не получил бы своего
+                size_t running = mThread.state() != Thread::State::NOT_RUNNING ? 1 : 0;
+                for (const auto& worker : mExtraWorkers)
+                {
+                    if (worker->state() != Thread::State::NOT_RUNNING) ++running;
+                }
+                for (size_t i = 0; i < running; ++i)
+                {
+                    enqueue(0, TaskItem{STOP_INDEX, T{}, nullptr}, portMAX_DELAY);
+                }
+
+                mThread.stop();
+                for (const auto& worker : mExtraWorkers) worker->stop();
+            }
+
+            // Потоки могли завершиться, не забрав прерывание или служебные задания (или не были
+            // запущены). Остаток удаляется здесь: иначе следующий поток очистил бы очередь вместе
+            // с новыми событиями, а записи объединения в заданиях ссылались бы на сброшенную таблицу
+            drain(mQueue);
+            for (auto& lane : mLanes) drain(*lane);
+            if constexpr (Lanes > 1)
+            {
+                while (mLaneSignal && xSemaphoreTake(mLaneSignal, 0) == pdTRUE) {}
+            }
+            resetCoalescing();
+
+            // Удалённые задания (в том числе очищенные прерыванием receive) уже не выполнятся:
+            // их Future отменяются, иначе invokeAndWait() и Future::wait() ждали бы вечно
+            mCompletions.cancelAll();
+        }
+
+        /// @brief Удалить все задания очереди и незабранное прерывание (рабочие потоки остановлены)
+        static void drain(TaskQueue& queue) noexcept
+        {
+            TaskItem item;
+            do
+            {
+                (void)queue.receive(item, 0);
+            } while (queue.waiting() > 0);
+        }
 
         /**
-         * @brief Остановка потока с гарантированным выходом
+         * @brief Проверка события по таблице объединения
+         * @param input Входные данные
+         * @param index Индекс callback
+         * @param slot Ссылка для записи таблицы, связанной с событием (-1 если нет)
+         * @param generation Ссылка для поколения таблицы, к которому относится запись
+         * @return true если событие нужно поставить в очередь
          */
-        void stopThread() noexcept
+        bool admit(const T& input, const int16_t index, int16_t& slot, uint16_t& generation) noexcept
+        {
+            std::lock_guard lock(mCoalesceMutex);
+            if (!mKeyExtractor) return true;
+
+            const uint32_t key = mKeyExtractor(input);
+            const TickType_t now = xTaskGetTickCount();
+
+            // Поиск записи с тем же ключом, иначе свободной или самой старой неожидающей
+            int16_t candidate = -1;
+            for (int16_t i = 0; i < BufferCapacity; ++i)
+            {
+                CoalesceEntry& entry = mCoalesce[i];
+                if (entry.used && entry.key == key && entry.itemIndex == index)
+                {
+                    if (entry.pending)
+                    {
+                        entry.data = input;
+                        return false;
+                    }
+                    if (mCoalesceWindow && now - entry.accepted < mCoalesceWindow)
+                    {
+                        return false;
+                    }
+                    candidate = i;
+                    break;
+                }
+
+                if (entry.pending) continue;
+                if (candidate < 0 || !entry.used ||
+                    (mCoalesce[candidate].used && now - entry.accepted > now - mCoalesce[candidate].accepted))
+                {
+                    candidate = i;
+                }
+            }
+
+            // Все записи заняты ожидающими событиями: событие ставится в очередь без объединения
+            if (candidate < 0) return true;
+
+            mCoalesce[candidate] = {key, index, true, true, now, input};
+            slot = candidate;
+            generation = mCoalesceGeneration;
+            return true;
+        }
+
+        /**
+         * @brief Получить актуальные данные объединённого события
+         * @param slot Запись таблицы объединения
+         * @param generation Поколение таблицы, в котором событие заняло запись
+         * @param data Ссылка для данных (не изменяется, если запись уже сброшена)
+         * @details Запись сброшенной таблицы могла перейти к событию с другим ключом,
+         * поэтому событие старого поколения её не трогает
+         */
+        void takeCoalesced(const int16_t slot, const uint16_t generation, T& data) noexcept
         {
-            mQueue.reset();
-            mThread.stop();
+            std::lock_guard lock(mCoalesceMutex);
+            if (generation != mCoalesceGeneration) return;
+            if (CoalesceEntry& entry = mCoalesce[slot]; entry.pending)
+            {
+                data = entry.data;
+                entry.pending = false;
+            }
+        }
+
+        /// @brief Сброс таблицы объединения (ожидавшие события удалены вместе с очередью)
+        void resetCoalescing() noexcept
+        {
+            std::lock_guard lock(mCoalesceMutex);
+            mCoalesce = {};
+            ++mCoalesceGeneration;
         }
 
         /**
          * @brief Обработка элементов callback
          * @param item Элемент задачи для обработки
          */
-        void process(const TaskItem& item) const noexcept
+        void process(const TaskItem& item) noexcept
         {
-            // 1. Быстро копируем нужные callback'и под блокировкой
-            std::vector<Item> activeCallbacks;
+            // Отменённый асинхронный вызов не обрабатывается: его Future может быть уже уничтожен
+            auto* const future = static_cast<Future*>(mCompletions.take(item.future));
+            if (item.future.valid() && !future) return;
+
+            // Объединённое событие обрабатывается с последними переданными данными
+            T data = item.data;
+            if (item.coalesceSlot >= 0) takeCoalesced(item.coalesceSlot, item.coalesceGeneration, data);
+
+            // Элементы снимка неизменны до free(), который сначала останавливает этот поток
+            const uint16_t count = snapshotCount(mSnapshot.load(std::memory_order_acquire));
+            for (uint16_t i = 0; i < count; ++i)
             {
-                std::lock_guard lock(mMutex);
-                activeCallbacks.reserve(mNumItems);
-                for (int i = 0; i < mNumItems; ++i)
+                if (const auto& cb = mItems[i]; !cb.onlyIndex || i == item.itemIndex)
                 {
-                    if (const auto& cb = mItems[i]; cb.func && (!cb.onlyIndex || i == item.itemIndex))
+                    T output;
+                    const uint32_t start = HandlerStatsType::now();
+                    const bool produced = cb.func(data, output);
+                    if constexpr (CALLBACK_PROFILING_ENABLED)
+                    {
+                        recordCall(cb, i, HandlerStatsType::now() - start);
+                    }
+
+                    if (produced)
                     {
-                        activeCallbacks.push_back(cb);
+                        if (item.response) item.response(output);
+                        if (future && !future->mResult) future->mResult = output;
                     }
                 }
             }
 
-            // 2. Обрабатываем без блокировки
-            for (const auto& cb : activeCallbacks)
+            if (future) future->complete();
+        }
+
+        /**
+         * @brief Учёт времени выполнения callback-функции
+         * @param cb Элемент callback
+         * @param index Индекс функции
+         * @param cycles Время выполнения в тактах
+         */
+        void recordCall(const Item& cb, const uint16_t index, const uint32_t cycles) const noexcept
+        {
+            const uint32_t threshold = mSlowThreshold.load(std::memory_order_relaxed);
+            if (cb.stats.onCall(cycles, threshold) && mLogSlow.load(std::memory_order_relaxed))
             {
-                if (T output; cb.func(item.data, output))
-                {
-                    if (item.response) item.response(output);
-                }
+                ESP_LOGW((utils::generateTag<Callback<T, FunctionCapacity, BufferCapacity, Lanes>>()),
+                         "Handler %u took %lu cycles (threshold %lu)", static_cast<unsigned>(index),
+                         (unsigned long)cycles, (unsigned long)threshold);
             }
         }
 
+        /// @brief Упаковка версии и количества функций в слово снимка
+        static constexpr uint32_t makeSnapshot(const uint32_t version, const uint32_t count) noexcept
+        {
+            return (version & 0xFFFF) << 16 | (count & 0xFFFF);
+        }
+
+        /// @brief Версия таблицы из слова снимка
+        static constexpr uint16_t snapshotVersion(const uint32_t snapshot) noexcept
+        {
+            return static_cast<uint16_t>(snapshot >> 16);
+        }
+
+        /// @brief Количество опубликованных функций из слова снимка
+        static constexpr uint16_t snapshotCount(const uint32_t snapshot) noexcept
+        {
+            return static_cast<uint16_t>(snapshot & 0xFFFF);
+        }
+
         /**
          * @brief Запуск/проверка рабочего потока
          * @return true если поток успешно запущен или уже работает
          */
         bool run()
         {
-            auto loop = [&]()
+            mStopRequested.store(false);
+            auto loop = [this]()
             {
-                if (TaskItem item; mQueue.receive(item))
+                return mExtraWorkers.empty() ? serveSingle() : servePooled();
+            };
+
+            bool started = mThread.quickStart(loop, Thread::LoopMode::EVENT_DRIVEN);
+            for (const auto& worker : mExtraWorkers)
+            {
+                started = worker->quickStart(loop, Thread::LoopMode::EVENT_DRIVEN) && started;
+            }
+            return started;
+        }
+
+        /**
+         * @brief Очередь уровня приоритета
+         * @param lane Уровень (значения больше Lanes - 1 ограничиваются старшим уровнем)
+         * @return Очередь уровня
+         */
+        TaskQueue& laneQueue(const uint8_t lane) noexcept
+        {
+            if constexpr (Lanes > 1)
+            {
+                if (lane > 0) return *mLanes[std::min<uint8_t>(lane, Lanes - 1) - 1];
+            }
+            return mQueue;
+        }
+
+        /**
+         * @brief Поставить задание в очередь уровня и разбудить рабочий поток
+         * @param lane Уровень приоритета
+         * @param item Задание
+         * @param ticksToWait Время ожидания места в очереди
+         * @return true если задание поставлено
+         */
+        bool enqueue(const uint8_t lane, TaskItem&& item, const TickType_t ticksToWait) noexcept
+        {
+            if (!laneQueue(lane).send(std::move(item), ticksToWait)) return false;
+            signalLanes();
+            return true;
+        }
+
+        /// @brief Сигнал рабочему потоку о новом элементе в одной из очередей уровней
+        void signalLanes() noexcept
+        {
+            if constexpr (Lanes > 1)
+            {
+                // Семафор не создаётся, если конструктор завершился ошибкой
+                if (mLaneSignal) xSemaphoreGive(mLaneSignal);
+            }
+        }
+
+        /**
+         * @brief Получение следующего задания с учётом приоритетов
+         * @param item Ссылка для сохранения задания
+         * @return true если задание получено, false при остановке или ошибке очереди
+         * @details Каждый сигнал mLaneSignal соответствует одному элементу в одной из очередей,
+         * поэтому после сигнала забирается ровно один элемент - самый приоритетный
+         * (вызывается из одного потока или под mDequeueMutex)
+         */
+        bool receiveNext(TaskItem& item) noexcept
+        {
+            if constexpr (Lanes == 1)
+            {
+                // Бесконечное ожидание завершается неудачей только при прерывании (reset) или ошибке очереди
+                return mQueue.receive(item);
+            }
+            else
+            {
+                while (xSemaphoreTake(mLaneSignal, portMAX_DELAY) == pdTRUE)
+                {
+                    if (takeByPriority(item, true) || takeByPriority(item, false)) return true;
+
+                    // Сигнал остановки или элемента, забранного раньше своего сигнала
+                    if (mStopRequested.load()) return false;
+                }
+                return false;
+            }
+        }
+
+        /**
+         * @brief Забрать элемент из старшей непустой очереди без ожидания
+         * @param item Ссылка для сохранения задания
+         * @param honorBudget Пропускать уровни, исчерпавшие бюджет при ожидающих младших уровнях
+         * @return true если задание получено
+         */
+        bool takeByPriority(TaskItem& item, const bool honorBudget) noexcept
+        {
+            const uint8_t budget = mStarvationBudget.load();
+            for (int lane = Lanes - 1; lane >= 0; --lane)
+            {
+                TaskQueue& queue = laneQueue(static_cast<uint8_t>(lane));
+                if (queue.waiting() == 0) continue;
+
+                const bool lowerWaiting = lowerLanesWaiting(lane);
+                if (honorBudget && budget && lowerWaiting && mLaneStreak[lane] >= budget) continue;
+
+                if (queue.receive(item, 0))
+                {
+                    mLaneStreak[lane] = lowerWaiting ? mLaneStreak[lane] + 1 : 0;
+                    for (int higher = lane + 1; higher < Lanes; ++higher) mLaneStreak[higher] = 0;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// @brief Есть ли задания в очередях ниже указанного уровня
+        bool lowerLanesWaiting(const int lane) noexcept
+        {
+            for (int lower = lane - 1; lower >= 0; --lower)
+            {
+                if (laneQueue(static_cast<uint8_t>(lower)).waiting() > 0) return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Итерация единственного рабочего потока
+         * @return Действие для цикла потока
+         */
+        Thread::LoopAction serveSingle() noexcept
+        {
+            TaskItem item;
+            if (!receiveNext(item))
+            {
+                // Прерывание, оставшееся от остановки без работающего потока (например, free()
+                // в конструкторе), не завершает поток, запущенный позже
+                return mStopRequested.load() ? Thread::LoopAction::STOP : Thread::LoopAction::CONTINUE;
+            }
+            process(item);
+            return Thread::LoopAction::CONTINUE;
+        }
+
+        /**
+         * @brief Итерация рабочего потока пула
+         * @return Действие для цикла потока
+         * @details Получение задания и выдача номера очерёдности выполняются под одним мьютексом,
+         * поэтому события одного индекса обрабатываются в порядке их следования в очереди
+         */
+        Thread::LoopAction servePooled() noexcept
+        {
+            TaskItem item;
+            IndexOrder* order = nullptr;
+            uint32_t ticket = 0;
+            {
+                std::lock_guard lock(mDequeueMutex);
+                if (!receiveNext(item) || item.itemIndex == STOP_INDEX)
                 {
-                    process(item);
+                    return Thread::LoopAction::STOP;
                 }
+                if (item.itemIndex >= 0 && item.itemIndex < mNumItems)
+                {
+                    order = &mOrder[item.itemIndex];
+                    ticket = order->next++;
+                }
+            }
+
+            if (!order)
+            {
+                process(item);
                 return Thread::LoopAction::CONTINUE;
-            };
-            return mThread.quickStart(loop);
+            }
+
+            {
+                std::unique_lock lock(mOrderMutex);
+                mOrderCv.wait(lock, [&] { return order->serving == ticket; });
+            }
+            process(item);
+            {
+                std::lock_guard lock(mOrderMutex);
+                ++order->serving;
+            }
+            mOrderCv.notify_all();
+            return Thread::LoopAction::CONTINUE;
         }
 
         /// Поток для обработки callback
         Thread mThread;
 
-        /// Очередь для хранения заданий
-        BufferedQueue<TaskItem, DEFAULT_BUFFER_SIZE> mQueue;
+        /// Очередь для хранения заданий (младший уровень приоритета)
+        TaskQueue mQueue;
+
+        /// Очереди старших уровней приоритета
+        std::array<std::optional<TaskQueue>, Lanes - 1> mLanes;
+
+        /// Счётчик элементов во всех очередях уровней (только при Lanes > 1)
+        SemaphoreHandle_t mLaneSignal = nullptr;
+
+        /// Память семафора уровней
+        StaticSemaphore_t mLaneSignalBuffer{};
+
+        /// Число подряд обработанных событий каждого уровня при ожидающих младших
+        std::array<uint8_t, Lanes> mLaneStreak{};
+
+        /// Бюджет защиты от голодания
+        std::atomic<uint8_t> mStarvationBudget{DEFAULT_STARVATION_BUDGET};
+
+        /// Запрошена остановка рабочего потока (сброс очереди)
+        std::atomic<bool> mStopRequested{false};
+
+        /// Дополнительные рабочие потоки (режим пула)
+        std::vector<std::unique_ptr<Thread>> mExtraWorkers;
+
+        /// Очерёдность обработки по индексам (только в режиме пула)
+        std::unique_ptr<IndexOrder[]> mOrder = nullptr;
+
+        /// Мьютекс получения заданий из очереди (режим пула)
+        std::mutex mDequeueMutex;
+
+        /// Мьютекс и условная переменная очерёдности (режим пула)
+        std::mutex mOrderMutex;
+        std::condition_variable mOrderCv;
 
-        /// Мьютекс для синхронизации
+        /// Мьютекс для синхронизации изменений таблицы
         mutable std::mutex mMutex;
 
+        /// Опубликованный снимок таблицы (старшие 16 бит - версия, младшие - количество функций)
+        std::atomic<uint32_t> mSnapshot{0};
+
+        /// Массив callback-функций в куче (если не задано статическое хранилище)
+        std::unique_ptr<Item[]> mOwnedItems = nullptr;
+
         /// Массив callback-функций
-        std::unique_ptr<Item[]> mItems = nullptr;
+        Item* mItems = nullptr;
 
-        /// Количество зарегистрированных callback-функций
+        /// Максимальное количество callback-функций
         uint8_t mNumItems = 0;
 
-        /// Индекс для быстрого поиска свободного слота
-        mutable int16_t mLastFreeIndex = 0;
+        /// Размер буфера из конструктора не превышает BufferCapacity
+        bool mBufferSizeValid = true;
+
+        /// Порог медленного вызова в тактах (0 - не проверять)
+        std::atomic<uint32_t> mSlowThreshold{0};
+
+        /// Выводить предупреждение о медленных вызовах
+        std::atomic<bool> mLogSlow{true};
+
+        /// Мьютекс таблицы объединения событий
+        std::mutex mCoalesceMutex;
+
+        /// Функция извлечения ключа (nullptr - объединение выключено)
+        KeyExtractor mKeyExtractor = nullptr;
+
+        /// Окно подавления дребезга в тиках
+        TickType_t mCoalesceWindow = 0;
+
+        /// Таблица объединения событий (по одной записи на слот буфера)
+        std::array<CoalesceEntry, BufferCapacity> mCoalesce{};
+
+        /// Поколение таблицы объединения (увеличивается при каждом сбросе)
+        uint16_t mCoalesceGeneration = 0;
+
+        /// Ссылки заданий в очереди на Future (по одной ячейке на слот буфера каждого уровня)
+        CompletionTable<BufferCapacity * Lanes> mCompletions;
     };
 } // namespace esp32_c3::objects
 
@@ -0,0 +1,339 @@
+#ifndef ESP32_C3_UTILS_COMPLETION_H
+#define ESP32_C3_UTILS_COMPLETION_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace esp32_c3::objects
+{
+    template <size_t Workers, size_t QueueCapacity, size_t JobCapacity>
+    class Executor;
+
+    class CompletionTableBase;
+
+    /**
+     * @brief Индекс уведомления, которым исполнитель будит задачу, ожидающую Completion
+     * @details При CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES < 3 используется общий индекс 0
+     */
+    constexpr UBaseType_t COMPLETION_NOTIFY_INDEX = configTASK_NOTIFICATION_ARRAY_ENTRIES > 2 ? 2 : 0;
+
+    /**
+     * @brief Ссылка задания в очереди на Completion через таблицу исполнителя
+     */
+    struct CompletionTicket
+    {
+        int16_t cell = -1;       ///< Ячейка таблицы (-1 - задание без Completion)
+        uint16_t generation = 0; ///< Поколение ячейки на момент постановки
+
+        /// @brief Задание отслеживается через Completion
+        [[nodiscard]] bool valid() const noexcept
+        {
+            return cell >= 0;
+        }
+    };
+
+    /**
+     * @brief Признак завершения асинхронного задания
+     * @details Хранится у вызывающего (обычно на стеке), поэтому постановка задания не выделяет память.
+     * Задание в очереди ссылается на объект не по адресу, а через ячейку таблицы исполнителя
+     * (CompletionTable): отмена очищает ячейку, и исполнитель больше не обращается к объекту.
+     * Исполнитель отмечает начало и конец обработки и будит ожидающую задачу
+     * прямым уведомлением (xTaskNotifyGiveIndexed).
+     * @note Объект нельзя перемещать, пока задание не завершено. Деструктор отменяет
+     * ещё не начатое задание или дожидается завершения уже начатого.
+     * Ожидание использует уведомление задачи с индексом COMPLETION_NOTIFY_INDEX.
+     * Объект с незавершённым заданием не должен пережить исполнитель
+     */
+    class Completion
+    {
+    public:
+        Completion() noexcept = default;
+
+        ~Completion() noexcept
+        {
+            cancelOrJoin();
+        }
+
+        // Запрет копирования и перемещения (исполнитель обращается к объекту по адресу)
+        Completion(const Completion&) = delete;
+        Completion& operator=(const Completion&) = delete;
+
+        /**
+         * @brief Проверка завершения задания
+         * @return true если задание выполнено
+         */
+        [[nodiscard]] bool ready() const noexcept
+        {
+            return mState.load() == State::DONE;
+        }
+
+        /**
+         * @brief Дождаться завершения задания
+         * @param ticksToWait Время ожидания
+         * @return true если задание выполнено (false - истекло время ожидания, задание отменено
+         * или не ставилось в очередь)
+         */
+        bool wait(const TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            return await(ticksToWait);
+        }
+
+    protected:
+        template <size_t Workers, size_t QueueCapacity, size_t JobCapacity>
+        friend class Executor;
+        friend class CompletionTableBase;
+
+        /// @brief Состояния задания
+        enum class State : uint8_t
+        {
+            IDLE,     ///< Задание не ставилось
+            PENDING,  ///< Задание в очереди
+            RUNNING,  ///< Задание выполняется
+            DONE,     ///< Задание завершено
+            CANCELLED ///< Задание отменено до начала выполнения
+        };
+
+        /// @brief Подготовка к новому заданию (false если предыдущее ещё не завершено)
+        bool arm() noexcept
+        {
+            if (const State state = mState.load(); state == State::PENDING || state == State::RUNNING)
+            {
+                return false;
+            }
+            mTable = nullptr;
+            mState.store(State::PENDING);
+            return true;
+        }
+
+        /// @brief Задание не попало в очередь
+        void abandon() noexcept
+        {
+            cancelOrJoin();
+        }
+
+        /// @brief Завершение выполнения и пробуждение ожидающей задачи
+        void complete() noexcept
+        {
+            // Хэндл забирается до публикации DONE: после неё объект может быть уже уничтожен.
+            // Ожидающая задача, не получившая хэндл обратно, дождётся этого уведомления сама
+            const TaskHandle_t waiter = mWaiter.exchange(nullptr);
+            mState.store(State::DONE);
+            if (waiter)
+            {
+                xTaskNotifyGiveIndexed(waiter, COMPLETION_NOTIFY_INDEX);
+            }
+        }
+
+        /// @brief Задание удалено из очереди без выполнения: отмена и пробуждение ожидающей задачи
+        void drop() noexcept
+        {
+            const TaskHandle_t waiter = mWaiter.exchange(nullptr);
+            mState.store(State::CANCELLED);
+            if (waiter)
+            {
+                xTaskNotifyGiveIndexed(waiter, COMPLETION_NOTIFY_INDEX);
+            }
+        }
+
+        /// @brief Отмена ожидающего задания или ожидание завершения начатого
+        void cancelOrJoin() noexcept;
+
+    private:
+        /**
+         * @brief Ожидание завершения задания текущей задачей
+         * @param ticksToWait Время ожидания
+         * @return true если задание выполнено
+         */
+        bool await(TickType_t ticksToWait) noexcept
+        {
+            mWaiter.store(xTaskGetCurrentTaskHandle());
+
+            TimeOut_t timeOut;
+            vTaskSetTimeOutState(&timeOut);
+
+            bool notified = false;
+            State state = mState.load();
+            while (state != State::DONE)
+            {
+                if (state == State::IDLE || state == State::CANCELLED ||
+                    xTaskCheckForTimeOut(&timeOut, &ticksToWait) != pdFALSE)
+                {
+                    break;
+                }
+                notified = ulTaskNotifyTakeIndexed(COMPLETION_NOTIFY_INDEX, pdFALSE, ticksToWait) > 0 || notified;
+                state = mState.load();
+            }
+
+            // Исполнитель забрал хэндл: уведомление уже отправлено или будет отправлено сразу после DONE.
+            // Оно забирается здесь, иначе осталось бы висеть до следующего ожидания этой задачи
+            if (mWaiter.exchange(nullptr) == nullptr && !notified)
+            {
+                ulTaskNotifyTakeIndexed(COMPLETION_NOTIFY_INDEX, pdFALSE, portMAX_DELAY);
+            }
+            return state == State::DONE;
+        }
+
+        std::atomic<State> mState{State::IDLE};     ///< Состояние задания
+        std::atomic<TaskHandle_t> mWaiter{nullptr}; ///< Задача, ожидающая завершения
+        CompletionTableBase* mTable = nullptr;      ///< Таблица, через которую на объект ссылается задание
+        CompletionTicket mTicket{};                 ///< Ячейка таблицы текущего задания
+    };
+
+    /**
+     * @brief Таблица ссылок заданий в очереди на объекты Completion
+     * @details Задание хранит номер ячейки и её поколение. Отмена очищает ячейку под мьютексом,
+     * поэтому отменённое задание, оставшееся в очереди, уже не найдёт объект. Повторно занятая
+     * ячейка получает новое поколение, и старое задание её не примет
+     */
+    class CompletionTableBase
+    {
+    public:
+        // Запрет копирования и перемещения (объекты Completion ссылаются на таблицу)
+        CompletionTableBase(const CompletionTableBase&) = delete;
+        CompletionTableBase& operator=(const CompletionTableBase&) = delete;
+
+        /**
+         * @brief Связать подготовленный (arm) объект с заданием перед постановкой в очередь
+         * @param completion Признак завершения
+         * @param ticket Ссылка для сохранения в задании
+         * @return true если свободная ячейка найдена
+         */
+        bool attach(Completion& completion, CompletionTicket& ticket) noexcept
+        {
+            std::lock_guard lock(mMutex);
+            for (size_t i = 0; i < mCells.size(); ++i)
+            {
+                Cell& cell = mCells[i];
+                if (cell.owner) continue;
+
+                cell.owner = &completion;
+                ticket = {static_cast<int16_t>(i), ++cell.generation};
+                completion.mTable = this;
+                completion.mTicket = ticket;
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Забрать объект задания перед выполнением (исполнитель)
+         * @param ticket Ссылка из задания
+         * @return Объект, переведённый в RUNNING, или nullptr если задание отменено
+         * @note После вызова объект существует до complete()
+         */
+        [[nodiscard]] Completion* take(const CompletionTicket ticket) noexcept
+        {
+            if (!ticket.valid()) return nullptr;
+
+            std::lock_guard lock(mMutex);
+            Cell& cell = mCells[ticket.cell];
+            if (!cell.owner || cell.generation != ticket.generation) return nullptr;
+
+            Completion* completion = cell.owner;
+            cell.owner = nullptr;
+            completion->mState.store(Completion::State::RUNNING);
+            return completion;
+        }
+
+        /**
+         * @brief Отменить все задания, ещё не забранные исполнителем
+         * @details Вызывается, когда исполнитель остановлен и его очередь очищена: ни одно
+         * оставшееся задание уже не выполнится. Ожидающие задачи просыпаются, wait() возвращает false
+         */
+        void cancelAll() noexcept
+        {
+            std::lock_guard lock(mMutex);
+            for (Cell& cell : mCells)
+            {
+                if (!cell.owner) continue;
+
+                // Под мьютексом: деструктор объекта не завершит отмену, пока ячейка не освобождена
+                Completion* completion = cell.owner;
+                cell.owner = nullptr;
+                completion->drop();
+            }
+        }
+
+    protected:
+        /**
+         * @brief Ячейка таблицы
+         */
+        struct Cell
+        {
+            Completion* owner = nullptr; ///< Объект задания в очереди (nullptr - ячейка свободна)
+            uint16_t generation = 0;     ///< Номер последнего занятия ячейки
+        };
+
+        CompletionTableBase() noexcept = default;
+        ~CompletionTableBase() = default;
+
+        std::span<Cell> mCells; ///< Ячейки (хранятся в производном классе)
+
+    private:
+        friend class Completion;
+
+        /// @brief Отменить задание, если исполнитель его ещё не забрал
+        bool cancel(Completion& completion) noexcept
+        {
+            std::lock_guard lock(mMutex);
+            Cell& cell = mCells[completion.mTicket.cell];
+            if (cell.owner != &completion || cell.generation != completion.mTicket.generation) return false;
+
+            cell.owner = nullptr;
+            completion.mState.store(Completion::State::CANCELLED);
+            return true;
+        }
+
+        std::mutex mMutex; ///< Защита ячеек
+    };
+
+    /**
+     * @brief Таблица ссылок на Completion фиксированного размера
+     * @tparam Capacity Количество ячеек (число заданий с Completion, одновременно ожидающих выполнения)
+     */
+    template <size_t Capacity>
+    class CompletionTable final : public CompletionTableBase
+    {
+        static_assert(Capacity > 0 && Capacity <= INT16_MAX, "Invalid completion table capacity");
+
+    public:
+        CompletionTable() noexcept
+        {
+            mCells = mStorage;
+        }
+
+    private:
+        std::array<Cell, Capacity> mStorage{}; ///< Ячейки таблицы
+    };
+
+    inline void Completion::cancelOrJoin() noexcept
+    {
+        const State state = mState.load();
+        if (state == State::PENDING)
+        {
+            // Задание не связано с таблицей (не поставлено) или ещё не забрано исполнителем
+            if (!mTable)
+            {
+                mState.store(State::CANCELLED);
+                return;
+            }
+            if (mTable->cancel(*this)) return;
+        }
+        else if (state != State::RUNNING)
+        {
+            return;
+        }
+
+        // Исполнитель уже забрал задание и обратится к объекту до complete()
+        await(portMAX_DELAY);
+    }
+} // namespace esp32_c3::objects
+
+#endif // ESP32_C3_UTILS_COMPLETION_H
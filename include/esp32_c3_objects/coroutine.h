@@ -0,0 +1,550 @@
+#ifndef ESP32_C3_UTILS_COROUTINE_H
+#define ESP32_C3_UTILS_COROUTINE_H
+
+#include "thread.h"
+#include "queue.h"
+#include "buffered_queue.h"
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace esp32_c3::objects
+{
+    class CoroutineRuntime;
+
+    template <size_t MaxFlows, size_t FrameSize>
+    struct CoroutineStorage;
+
+    /**
+     * @brief Сопрограмма, выполняемая CoroutineRuntime
+     * @details Функция-сопрограмма возвращает Coroutine и первым параметром принимает CoroutineRuntime&:
+     * кадр сопрограммы размещается в пуле этого исполнителя, а не в куче.
+     * Созданная сопрограмма не выполняется, пока не передана в CoroutineRuntime::spawn().
+     * @note Если кадр не помещается в пул или пул исчерпан, возвращается пустой объект
+     */
+    class Coroutine
+    {
+    public:
+        /**
+         * @brief Обещание сопрограммы (интерфейс компилятора)
+         */
+        struct promise_type
+        {
+            /// @brief Размещение кадра в пуле исполнителя (первый параметр сопрограммы)
+            template <typename... Args>
+            static void* operator new(size_t size, CoroutineRuntime& runtime, Args&...) noexcept;
+
+            /// @brief Возврат кадра в пул исполнителя
+            static void operator delete(void* frame, size_t size) noexcept;
+
+            static Coroutine get_return_object_on_allocation_failure() noexcept
+            {
+                return {};
+            }
+
+            Coroutine get_return_object() noexcept
+            {
+                return Coroutine{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            /// @brief Объект, владеющий ещё не переданным в spawn() кадром
+            Coroutine* owner = nullptr;
+
+            static std::suspend_always initial_suspend() noexcept { return {}; }
+            static std::suspend_always final_suspend() noexcept { return {}; }
+            static void return_void() noexcept {}
+            static void unhandled_exception() noexcept { std::abort(); }
+        };
+
+        Coroutine() noexcept = default;
+
+        ~Coroutine() noexcept
+        {
+            if (mHandle) mHandle.destroy();
+        }
+
+        // Запрет копирования
+        Coroutine(const Coroutine&) = delete;
+        Coroutine& operator=(const Coroutine&) = delete;
+
+        // Поддержка перемещения
+        Coroutine(Coroutine&& other) noexcept :
+            mHandle(std::exchange(other.mHandle, nullptr))
+        {
+            adopt();
+        }
+
+        Coroutine& operator=(Coroutine&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (mHandle) mHandle.destroy();
+                mHandle = std::exchange(other.mHandle, nullptr);
+                adopt();
+            }
+            return *this;
+        }
+
+        /// @brief Проверка, что кадр сопрограммы создан
+        explicit operator bool() const noexcept
+        {
+            return static_cast<bool>(mHandle);
+        }
+
+    private:
+        friend class CoroutineRuntime;
+
+        explicit Coroutine(const std::coroutine_handle<promise_type> handle) noexcept :
+            mHandle(handle)
+        {
+            adopt();
+        }
+
+        /// @brief Сообщить кадру адрес владельца (исполнитель сбрасывает его при уничтожении кадра)
+        void adopt() noexcept
+        {
+            if (mHandle) mHandle.promise().owner = this;
+        }
+
+        std::coroutine_handle<promise_type> mHandle; ///< Кадр сопрограммы
+    };
+
+    /**
+     * @brief Исполнитель сопрограмм в одном потоке
+     * @details Сотни независимых сценариев (конечных автоматов протоколов и т.п.) выполняются на стеке
+     * одного Thread: каждый сценарий - сопрограмма, кадр которой хранится в фиксированном пуле
+     * CoroutineStorage. Сопрограммы приостанавливаются на ожиданиях delay(), yield(), receive()
+     * и notified() и возобновляются по очереди потоком исполнителя, который спит до ближайшего
+     * срока или события.
+     * @note Пока сопрограмма ожидает Queue или BufferedQueue, на очереди установлен обработчик
+     * отправки исполнителя (QueueSendHook): поток просыпается по отправке, а не опрашивает очередь.
+     * Отправка напрямую через хэндл FreeRTOS обработчик не вызывает - после неё нужен wake().
+     * Очередь, на которой уже установлен чужой обработчик, опрашивается раз в тик.
+     * Функции исполнителя, кроме notifyFromISR(), нельзя вызывать из прерываний
+     */
+    class CoroutineRuntime
+    {
+    public:
+        /// @brief Идентификатор сопрограммы (номер слота пула)
+        using FlowId = int16_t;
+
+        /// @brief Идентификатор, возвращаемый при ошибке
+        static constexpr FlowId INVALID_FLOW = -1;
+
+        /// @brief Размер стека по умолчанию
+        static constexpr uint32_t DEFAULT_STACK_DEPTH = 4096;
+
+        /// @brief Приоритет по умолчанию
+        static constexpr UBaseType_t DEFAULT_PRIORITY = 5;
+
+        /// @brief Служебный заголовок перед каждым кадром (указатель на исполнитель)
+        static constexpr size_t FRAME_HEADER = alignof(std::max_align_t);
+
+        /// @brief Тег для логирования
+        static constexpr auto TAG = "CoroutineRuntime";
+
+        /**
+         * @brief Ожидание, на котором приостановлена сопрограмма
+         */
+        struct Wait
+        {
+            bool (*check)(void*) = nullptr; ///< Проверка готовности (nullptr - только по сроку)
+            void* awaiter = nullptr;        ///< Объект ожидания в кадре сопрограммы
+            TickType_t deadline = 0;        ///< Срок возобновления
+            bool hasDeadline = false;       ///< Срок задан
+            bool periodic = false;          ///< Готовность нужно проверять каждый тик
+            const void* source = nullptr;   ///< Очередь с обработчиком отправки исполнителя
+
+            /// Снятие обработчика отправки с очереди source
+            void (*detach)(const void* source, const QueueSendHook& hook) = nullptr;
+        };
+
+        /**
+         * @brief Слот пула сопрограмм
+         */
+        struct Slot
+        {
+            /// @brief Состояния слота
+            enum class State : uint8_t
+            {
+                FREE,      ///< Слот свободен
+                ALLOCATED, ///< Кадр создан, но не передан в spawn()
+                WAITING,   ///< Сопрограмма ожидает
+                RUNNING    ///< Сопрограмма выполняется
+            };
+
+            std::atomic<State> state{State::FREE}; ///< Состояние слота
+            std::atomic<bool> cancelRequested{};   ///< Запрошено уничтожение сопрограммы
+            std::coroutine_handle<> handle;        ///< Кадр сопрограммы
+            Wait wait;                             ///< Текущее ожидание
+        };
+
+        /**
+         * @brief Конструктор исполнителя
+         * @tparam MaxFlows Максимальное количество сопрограмм
+         * @tparam FrameSize Максимальный размер кадра сопрограммы в байтах
+         * @param name Имя потока
+         * @param storage Пул кадров (должен существовать дольше исполнителя)
+         * @param stackDepth Размер стека потока
+         * @param priority Приоритет потока
+         */
+        template <size_t MaxFlows, size_t FrameSize>
+        CoroutineRuntime(const std::string_view name, CoroutineStorage<MaxFlows, FrameSize>& storage,
+                         const uint32_t stackDepth = DEFAULT_STACK_DEPTH,
+                         const UBaseType_t priority = DEFAULT_PRIORITY) noexcept :
+            mThread(name, stackDepth, priority),
+            mSlots(storage.slots),
+            mFrames(storage.frames.data()->data),
+            mFrameStride(sizeof(typename CoroutineStorage<MaxFlows, FrameSize>::Frame)),
+            mFrameSize(FrameSize),
+            mSendHook{onQueueSend, onQueueSendFromISR, this}
+        {
+            // Исполнитель спит на уведомлении с индексом 0, которое Thread при остановке не отправляет
+            mThread.setWakeHook([this] { wake(); });
+        }
+
+        /**
+         * @brief Деструктор - останавливает поток и уничтожает незавершённые сопрограммы
+         * @note Кадры, созданные, но не переданные в spawn(), тоже уничтожаются, а владеющие ими
+         * объекты Coroutine становятся пустыми. Эти объекты нельзя использовать из других задач
+         * одновременно с деструктором
+         */
+        ~CoroutineRuntime() noexcept;
+
+        // Запрет копирования и перемещения (кадры ссылаются на исполнитель)
+        CoroutineRuntime(const CoroutineRuntime&) = delete;
+        CoroutineRuntime& operator=(const CoroutineRuntime&) = delete;
+
+        /**
+         * @brief Запуск потока исполнителя
+         * @return true если поток запущен или уже работает
+         */
+        bool start() noexcept;
+
+        /**
+         * @brief Остановка потока исполнителя
+         * @note Сопрограммы остаются приостановленными и продолжат выполнение после start()
+         */
+        void stop() noexcept;
+
+        /**
+         * @brief Передать сопрограмму на выполнение
+         * @param flow Созданная сопрограмма
+         * @return Идентификатор сопрограммы или INVALID_FLOW (кадр не был создан
+         * или размещён в пуле другого исполнителя)
+         * @note Сопрограмма начинает выполняться в потоке исполнителя
+         */
+        FlowId spawn(Coroutine&& flow) noexcept;
+
+        /**
+         * @brief Отменить сопрограмму
+         * @param id Идентификатор сопрограммы
+         * @return true если сопрограмма существовала
+         * @details Кадр уничтожается потоком исполнителя в точке ожидания: деструкторы локальных
+         * объектов выполняются, код после точки ожидания - нет
+         */
+        bool cancel(FlowId id) noexcept;
+
+        /**
+         * @brief Проверка, что сопрограмма ещё не завершилась
+         * @param id Идентификатор сопрограммы
+         */
+        [[nodiscard]] bool isAlive(FlowId id) const noexcept;
+
+        /// @brief Количество незавершённых сопрограмм
+        [[nodiscard]] size_t activeFlows() const noexcept;
+
+        /**
+         * @brief Выставить биты событий для сопрограмм, ожидающих notified()
+         * @param bits Биты событий
+         * @note Биты сохраняются до тех пор, пока их не заберёт ожидающая сопрограмма
+         */
+        void notify(uint32_t bits) noexcept;
+
+        /**
+         * @brief Выставить биты событий из обработчика прерывания
+         * @param bits Биты событий
+         * @param higherPriorityTaskWoken Флаг переключения контекста (только устанавливается, не сбрасывается)
+         */
+        void notifyFromISR(uint32_t bits, BaseType_t& higherPriorityTaskWoken) noexcept;
+
+        /**
+         * @brief Разбудить поток исполнителя для немедленной проверки ожиданий
+         * @note Например, после отправки в очередь, которую ожидает сопрограмма
+         */
+        void wake() noexcept;
+
+        /// @brief Поток исполнителя
+        [[nodiscard]] Thread& thread() noexcept
+        {
+            return mThread;
+        }
+
+        /**
+         * @brief Ожидание по сроку
+         */
+        struct DelayAwaiter
+        {
+            CoroutineRuntime* runtime; ///< Исполнитель
+            TickType_t ticks;          ///< Длительность ожидания
+
+            static bool await_ready() noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<>) const noexcept
+            {
+                runtime->park({nullptr, nullptr, 0, true, false}, ticks);
+            }
+
+            static void await_resume() noexcept {}
+        };
+
+        /**
+         * @brief Ожидание элемента очереди с таймаутом
+         * @tparam QueueType Queue<T> или BufferedQueue<T, ...>
+         * @tparam T Тип элемента
+         * @details На время ожидания на очередь устанавливается обработчик отправки исполнителя
+         */
+        template <typename QueueType, typename T>
+        struct ReceiveAwaiter
+        {
+            CoroutineRuntime* runtime; ///< Исполнитель
+            QueueType* queue;          ///< Очередь
+            T* item;                   ///< Буфер для элемента
+            TickType_t ticks;          ///< Время ожидания
+            bool received = false;     ///< Элемент получен
+
+            bool await_ready() noexcept
+            {
+                return received = poll(*queue, *item);
+            }
+
+            void await_suspend(std::coroutine_handle<>) noexcept
+            {
+                // Без обработчика (очередь занята другим) готовность проверяется каждый тик
+                const bool hooked = queue->attachSendHook(runtime->mSendHook);
+                runtime->park({check, this, 0, ticks != portMAX_DELAY, !hooked, hooked ? queue : nullptr, detach},
+                              ticks);
+            }
+
+            [[nodiscard]] bool await_resume() const noexcept
+            {
+                return received;
+            }
+
+            static bool check(void* self) noexcept
+            {
+                auto* awaiter = static_cast<ReceiveAwaiter*>(self);
+                return awaiter->received = poll(*awaiter->queue, *awaiter->item);
+            }
+
+            static void detach(const void* source, const QueueSendHook& hook) noexcept
+            {
+                static_cast<const QueueType*>(source)->detachSendHook(hook);
+            }
+
+            static bool poll(Queue<T>& source, T& out) noexcept
+            {
+                return source.receive(out, 0) == QueueReceiveResult::SUCCESS;
+            }
+
+            template <size_t BufferSize, FreeSlotTracking Tracking>
+            static bool poll(BufferedQueue<T, BufferSize, Tracking>& source, T& out) noexcept
+            {
+                return source.waiting() > 0 && source.receive(out, 0);
+            }
+        };
+
+        /**
+         * @brief Ожидание битов событий
+         */
+        struct NotifyAwaiter
+        {
+            CoroutineRuntime* runtime; ///< Исполнитель
+            uint32_t mask;             ///< Ожидаемые биты
+            TickType_t ticks;          ///< Время ожидания
+            uint32_t bits = 0;         ///< Полученные биты
+
+            bool await_ready() noexcept
+            {
+                bits = runtime->takeBits(mask);
+                return bits != 0;
+            }
+
+            void await_suspend(std::coroutine_handle<>) noexcept
+            {
+                runtime->park({check, this, 0, ticks != portMAX_DELAY, false}, ticks);
+            }
+
+            [[nodiscard]] uint32_t await_resume() const noexcept
+            {
+                return bits;
+            }
+
+            static bool check(void* self) noexcept
+            {
+                auto* awaiter = static_cast<NotifyAwaiter*>(self);
+                awaiter->bits = awaiter->runtime->takeBits(awaiter->mask);
+                return awaiter->bits != 0;
+            }
+        };
+
+        /**
+         * @brief Приостановить сопрограмму на заданное время
+         * @param ms Время в миллисекундах (0 - уступить очередь остальным сопрограммам)
+         * @return Объект ожидания для co_await
+         */
+        [[nodiscard]] DelayAwaiter delay(const uint32_t ms) noexcept
+        {
+            return {this, pdMS_TO_TICKS(ms)};
+        }
+
+        /**
+         * @brief Уступить очередь остальным готовым сопрограммам
+         * @return Объект ожидания для co_await
+         */
+        [[nodiscard]] DelayAwaiter yield() noexcept
+        {
+            return {this, 0};
+        }
+
+        /**
+         * @brief Получить элемент из Queue
+         * @param queue Очередь
+         * @param item Ссылка для сохранения элемента
+         * @param ticksToWait Время ожидания
+         * @return Объект ожидания для co_await (результат - true если элемент получен)
+         */
+        template <typename T>
+        [[nodiscard]] ReceiveAwaiter<Queue<T>, T> receive(Queue<T>& queue, T& item,
+                                                          const TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            return {this, &queue, &item, ticksToWait};
+        }
+
+        /**
+         * @brief Получить элемент из BufferedQueue
+         * @param queue Очередь
+         * @param item Ссылка для сохранения элемента
+         * @param ticksToWait Время ожидания
+         * @return Объект ожидания для co_await (результат - true если элемент получен)
+         */
+        template <typename T, size_t BufferSize, FreeSlotTracking Tracking>
+        [[nodiscard]] ReceiveAwaiter<BufferedQueue<T, BufferSize, Tracking>, T>
+        receive(BufferedQueue<T, BufferSize, Tracking>& queue, T& item,
+                const TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            return {this, &queue, &item, ticksToWait};
+        }
+
+        /**
+         * @brief Дождаться битов событий, выставленных notify()
+         * @param mask Ожидаемые биты
+         * @param ticksToWait Время ожидания
+         * @return Объект ожидания для co_await (результат - полученные биты из mask, 0 при таймауте)
+         * @note Полученные биты сбрасываются
+         */
+        [[nodiscard]] NotifyAwaiter notified(const uint32_t mask, const TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            return {this, mask, ticksToWait};
+        }
+
+    private:
+        friend struct Coroutine::promise_type;
+
+        /// @brief Разместить кадр сопрограммы в пуле
+        void* allocateFrame(size_t size) noexcept;
+
+        /// @brief Вернуть кадр в пул исполнителя-владельца
+        static void freeFrame(void* frame) noexcept;
+
+        /// @brief Номер слота по адресу кадра (INVALID_FLOW - кадр не из пула этого исполнителя)
+        [[nodiscard]] FlowId slotOf(const void* frame) const noexcept;
+
+        /**
+         * @brief Зарегистрировать ожидание выполняющейся сопрограммы
+         * @param wait Ожидание
+         * @param ticks Время ожидания (portMAX_DELAY - без срока)
+         */
+        void park(Wait wait, TickType_t ticks) noexcept;
+
+        /// @brief Забрать выставленные биты событий из mask
+        uint32_t takeBits(uint32_t mask) noexcept;
+
+        /// @brief Снять обработчик отправки с очереди ожидания, если её больше не ожидает ни одна сопрограмма
+        void releaseSource(const Wait& wait) const noexcept;
+
+        /// @brief Обработчик отправки в ожидаемую очередь
+        static void onQueueSend(void* context) noexcept;
+
+        /// @brief Обработчик отправки в ожидаемую очередь из прерывания
+        static void onQueueSendFromISR(void* context, BaseType_t& higherPriorityTaskWoken) noexcept;
+
+        /**
+         * @brief Один проход потока: возобновление готовых сопрограмм и ожидание
+         * @return Действие для цикла потока
+         */
+        Thread::LoopAction runOnce() noexcept;
+
+        /// @brief Уничтожить кадр сопрограммы
+        static void destroy(Slot& slot) noexcept;
+
+        Thread mThread; ///< Поток исполнителя
+
+        std::span<Slot> mSlots;  ///< Слоты пула
+        std::byte* mFrames;      ///< Память кадров
+        size_t mFrameStride;     ///< Шаг кадров в памяти
+        size_t mFrameSize;       ///< Полезный размер кадра
+
+        QueueSendHook mSendHook; ///< Обработчик отправки, устанавливаемый на ожидаемые очереди
+
+        std::atomic<TaskHandle_t> mTask{nullptr}; ///< Задача исполнителя
+        std::atomic<uint32_t> mBits{0};           ///< Выставленные биты событий
+        FlowId mCurrent = INVALID_FLOW;           ///< Выполняющаяся сопрограмма
+    };
+
+    /**
+     * @brief Статический пул кадров сопрограмм (без выделения памяти в куче)
+     * @tparam MaxFlows Максимальное количество сопрограмм
+     * @tparam FrameSize Максимальный размер кадра сопрограммы в байтах
+     * @details Размер кадра зависит от локальных переменных сопрограммы и известен только компилятору:
+     * сопрограмма, кадр которой не помещается в FrameSize, не создаётся (ошибка в журнале содержит
+     * требуемый размер)
+     */
+    template <size_t MaxFlows, size_t FrameSize>
+    struct CoroutineStorage
+    {
+        static_assert(MaxFlows > 0 && MaxFlows < INT16_MAX, "Coroutine pool must have between 1 and 32766 frames");
+
+        /// @brief Память одного кадра со служебным заголовком
+        struct alignas(std::max_align_t) Frame
+        {
+            std::byte data[CoroutineRuntime::FRAME_HEADER + FrameSize];
+        };
+
+        std::array<Frame, MaxFlows> frames;                   ///< Кадры
+        std::array<CoroutineRuntime::Slot, MaxFlows> slots{}; ///< Состояния слотов
+    };
+
+    template <typename... Args>
+    void* Coroutine::promise_type::operator new(const size_t size, CoroutineRuntime& runtime, Args&...) noexcept
+    {
+        return runtime.allocateFrame(size);
+    }
+
+    inline void Coroutine::promise_type::operator delete(void* frame, size_t) noexcept
+    {
+        CoroutineRuntime::freeFrame(frame);
+    }
+} // namespace esp32_c3::objects
+
+#endif // ESP32_C3_UTILS_COROUTINE_H
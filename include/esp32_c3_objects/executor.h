@@ -0,0 +1,249 @@
+#ifndef ESP32_C3_UTILS_EXECUTOR_H
+#define ESP32_C3_UTILS_EXECUTOR_H
+
+#include "thread.h"
+#include "buffered_queue.h"
+#include "completion.h"
+#include "esp32_c3_utils/inplace_function.h"
+#include "esp32_c3_utils/type_utils.h"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+
+#include <freertos/FreeRTOS.h>
+#include <esp_log.h>
+
+namespace esp32_c3::objects
+{
+    /**
+     * @brief Исполнитель разовых заданий на фиксированном наборе потоков
+     * @tparam Workers Количество рабочих потоков
+     * @tparam QueueCapacity Максимальное количество заданий в очереди
+     * @tparam JobCapacity Размер встроенного буфера под захваченное состояние задания (в байтах)
+     * @details Задание - вызываемый объект без аргументов, хранящийся прямо в слоте очереди
+     * (utils::InplaceFunction), поэтому постановка задания не обращается к куче и не создаёт задачу.
+     * Потоки создаются один раз при первой постановке задания и выполняют задания в порядке очереди.
+     * Завершение отдельного задания можно дождаться через Completion.
+     */
+    template <size_t Workers, size_t QueueCapacity, size_t JobCapacity = utils::INPLACE_FUNCTION_DEFAULT_CAPACITY>
+    class Executor
+    {
+        static_assert(Workers > 0, "Executor must have at least one worker");
+        static_assert(QueueCapacity >= Workers, "Queue must fit a stop request for every worker");
+
+    public:
+        /// @brief Тип задания
+        using Job = utils::InplaceFunction<void(), JobCapacity>;
+
+        /// @brief Размер стека рабочего потока по умолчанию
+        static constexpr uint32_t DEFAULT_STACK_DEPTH = 3072;
+
+        /// @brief Приоритет рабочих потоков по умолчанию
+        static constexpr UBaseType_t DEFAULT_PRIORITY = 10;
+
+        /**
+         * @brief Конструктор исполнителя
+         * @param name Имя исполнителя (рабочие потоки получают имена name#0, name#1, ...)
+         * @param stackDepth Размер стека каждого рабочего потока
+         * @param priority Приоритет рабочих потоков
+         */
+        explicit Executor(const char* name,
+                          const uint32_t stackDepth = DEFAULT_STACK_DEPTH,
+                          const UBaseType_t priority = DEFAULT_PRIORITY) noexcept :
+            mQueue(QueueCapacity)
+        {
+            for (size_t i = 0; i < Workers; ++i)
+            {
+                char workerName[THREAD_NAME_SIZE];
+                std::snprintf(workerName, sizeof(workerName), "%s#%u", name, static_cast<unsigned>(i));
+                mWorkers[i].emplace(workerName, stackDepth, priority);
+            }
+
+            if (!mQueue.isValid())
+            {
+                ESP_LOGE((utils::generateTag<Executor<Workers, QueueCapacity, JobCapacity>>()),
+                         "Executor %s creation failed", name);
+            }
+        }
+
+        ~Executor() noexcept
+        {
+            shutdown();
+        }
+
+        // Запрет копирования и перемещения (рабочие потоки ссылаются на объект)
+        Executor(const Executor&) = delete;
+        Executor& operator=(const Executor&) = delete;
+
+        /**
+         * @brief Проверка инициализации
+         * @return true если очередь заданий создана
+         */
+        [[nodiscard]] bool isInitialized() const noexcept
+        {
+            return mQueue.isValid();
+        }
+
+        /**
+         * @brief Поставить задание в очередь
+         * @param job Задание
+         * @param ticksToWait Время ожидания места в очереди
+         * @return true если задание поставлено
+         */
+        bool submit(Job job, const TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            if (!job || !isInitialized() || !ensureRunning()) return false;
+            return mQueue.emplace(ticksToWait, std::move(job), CompletionTicket{});
+        }
+
+        /**
+         * @brief Поставить задание в очередь с отслеживанием завершения
+         * @param job Задание
+         * @param completion Признак завершения (должен существовать до завершения задания)
+         * @param ticksToWait Время ожидания места в очереди
+         * @return true если задание поставлено (false также если предыдущее задание
+         * с этим completion ещё не завершено или ожидают выполнения уже QueueCapacity
+         * заданий с Completion)
+         */
+        bool submit(Job job, Completion& completion, const TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            if (!job || !isInitialized() || !ensureRunning() || !completion.arm()) return false;
+
+            CompletionTicket ticket;
+            if (!mCompletions.attach(completion, ticket))
+            {
+                completion.abandon();
+                ESP_LOGE((utils::generateTag<Executor<Workers, QueueCapacity, JobCapacity>>()),
+                         "No free completion slots");
+                return false;
+            }
+            if (!mQueue.emplace(ticksToWait, std::move(job), ticket))
+            {
+                completion.abandon();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Остановка рабочих потоков
+         * @note Задания, поставленные до вызова, выполняются до остановки.
+         * Следующий submit() снова запускает потоки.
+         * Вызов из задания этого исполнителя отклоняется: поток не может дождаться сам себя,
+         * а при заполненной очереди постановка остановки заблокировала бы его навсегда
+         */
+        void shutdown() noexcept
+        {
+            if (!isInitialized()) return;
+
+            for (const auto& worker : mWorkers)
+            {
+                if (worker->isCurrent())
+                {
+                    ESP_LOGE((utils::generateTag<Executor<Workers, QueueCapacity, JobCapacity>>()),
+                             "shutdown() called from a job, ignored");
+                    return;
+                }
+            }
+
+            // Прерывание receive будит только один поток, поэтому каждому работающему потоку
+            // отправляется пустое задание; задания перед ним успевают выполниться.
+            // Пустое задание забирает любой поток, поэтому работающие потоки считаются до отправки
+            size_t running = 0;
+            for (const auto& worker : mWorkers)
+            {
+                if (worker->state() != Thread::State::NOT_RUNNING) ++running;
+            }
+            for (size_t i = 0; i < running; ++i)
+            {
+                mQueue.emplace(portMAX_DELAY, Job{}, CompletionTicket{});
+            }
+            for (auto& worker : mWorkers) worker->stop();
+
+            // Флаг сбрасывается после остановки: задание, поставленное во время остановки,
+            // ещё видит работающие потоки и выполнится после следующего запуска
+            std::lock_guard lock(mStartMutex);
+            mRunning.store(false, std::memory_order_release);
+        }
+
+        /// @brief Количество заданий, ожидающих выполнения
+        [[nodiscard]] size_t pending() const noexcept
+        {
+            return mQueue.waiting();
+        }
+
+    private:
+        /**
+         * @brief Задание в очереди
+         */
+        struct Task
+        {
+            Job job;                     ///< Задание (пустое - остановка рабочего потока)
+            CompletionTicket completion; ///< Ссылка на признак завершения (может быть пустой)
+
+            Task(Job&& j, const CompletionTicket c) noexcept :
+                job(std::move(j)),
+                completion(c)
+            {
+            }
+        };
+
+        /**
+         * @brief Запуск рабочих потоков при первой постановке после создания или shutdown()
+         * @return true если все потоки запущены или уже работают
+         * @details Рабочие потоки завершаются только по shutdown(), поэтому постановка проверяет
+         * флаг, а не состояние каждого потока
+         */
+        bool ensureRunning() noexcept
+        {
+            if (mRunning.load(std::memory_order_acquire)) return true;
+
+            std::lock_guard lock(mStartMutex);
+            if (mRunning.load(std::memory_order_relaxed)) return true;
+
+            const auto loop = [this] { return serve(); };
+
+            bool started = true;
+            for (auto& worker : mWorkers)
+            {
+                started = worker->quickStart(loop, Thread::LoopMode::EVENT_DRIVEN) && started;
+            }
+            mRunning.store(started, std::memory_order_release);
+            return started;
+        }
+
+        /**
+         * @brief Выполнение одного задания рабочим потоком
+         * @return Действие для цикла потока
+         */
+        Thread::LoopAction serve() noexcept
+        {
+            // Задание выполняется прямо в слоте очереди; слот освобождается после выполнения
+            const auto slot = mQueue.peek();
+            if (!slot) return Thread::LoopAction::CONTINUE;
+
+            Task& task = *slot;
+            if (!task.job) return Thread::LoopAction::STOP;
+
+            // Отменённое задание больше не связано с объектом Completion и пропускается
+            Completion* completion = mCompletions.take(task.completion);
+            if (!task.completion.valid() || completion)
+            {
+                task.job();
+                if (completion) completion->complete();
+            }
+            return Thread::LoopAction::CONTINUE;
+        }
+
+        BufferedQueue<Task, QueueCapacity> mQueue;           ///< Очередь заданий
+        std::array<std::optional<Thread>, Workers> mWorkers; ///< Рабочие потоки
+        CompletionTable<QueueCapacity> mCompletions;         ///< Ссылки заданий на Completion
+        std::atomic<bool> mRunning{false};                   ///< Рабочие потоки запущены
+        std::mutex mStartMutex;                              ///< Запуск потоков
+    };
+} // namespace esp32_c3::objects
+
+#endif // ESP32_C3_UTILS_EXECUTOR_H
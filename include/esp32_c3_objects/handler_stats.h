@@ -0,0 +1,138 @@
+#ifndef ESP32_C3_UTILS_HANDLER_STATS_H
+#define ESP32_C3_UTILS_HANDLER_STATS_H
+
+/**
+ * @file handler_stats.h
+ * @brief Профилирование callback-функций: количество вызовов, суммарное и максимальное время
+ * @details Сбор статистики включается макросом ENABLE_CALLBACK_PROFILING (например, -D ENABLE_CALLBACK_PROFILING).
+ * Без него Callback использует пустую заглушку NoHandlerStats, и профилирование ничего не стоит.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include <esp_cpu.h>
+
+namespace esp32_c3::objects
+{
+#ifdef ENABLE_CALLBACK_PROFILING
+    /// @brief Признак включённого профилирования callback-функций
+    constexpr bool CALLBACK_PROFILING_ENABLED = true;
+#else
+    /// @brief Признак включённого профилирования callback-функций
+    constexpr bool CALLBACK_PROFILING_ENABLED = false;
+#endif
+
+    /**
+     * @brief Снимок статистики одной callback-функции
+     */
+    struct HandlerProfile
+    {
+        uint32_t calls = 0;       ///< Количество вызовов
+        uint64_t totalCycles = 0; ///< Суммарное время выполнения в тактах
+        uint32_t maxCycles = 0;   ///< Максимальное время одного вызова в тактах
+        uint32_t slowCalls = 0;   ///< Вызовы, превысившие порог
+    };
+
+    /**
+     * @brief Счётчики времени выполнения одной callback-функции
+     * @note Копирование переносит текущие значения счётчиков (нужно для переприсваивания слота).
+     * Счётчики изменяемы у константного объекта: worker-поток видит таблицу функций только для чтения
+     */
+    class HandlerStats
+    {
+    public:
+        HandlerStats() noexcept = default;
+
+        HandlerStats(const HandlerStats& other) noexcept
+        {
+            assign(other.snapshot());
+        }
+
+        HandlerStats& operator=(const HandlerStats& other) noexcept
+        {
+            if (this != &other) assign(other.snapshot());
+            return *this;
+        }
+
+        /// @brief Текущее значение счётчика тактов
+        [[nodiscard]] static uint32_t now() noexcept
+        {
+            return static_cast<uint32_t>(esp_cpu_get_cycle_count());
+        }
+
+        /**
+         * @brief Учесть вызов
+         * @param cycles Время выполнения в тактах
+         * @param threshold Порог медленного вызова в тактах (0 - не проверять)
+         * @return true если вызов превысил порог
+         */
+        bool onCall(const uint32_t cycles, const uint32_t threshold) const noexcept
+        {
+            mCalls.fetch_add(1, std::memory_order_relaxed);
+            mTotalCycles.fetch_add(cycles, std::memory_order_relaxed);
+
+            uint32_t current = mMaxCycles.load(std::memory_order_relaxed);
+            while (cycles > current &&
+                !mMaxCycles.compare_exchange_weak(current, cycles, std::memory_order_relaxed))
+            {
+            }
+
+            if (threshold == 0 || cycles <= threshold) return false;
+            mSlowCalls.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+         * @brief Получить снимок статистики
+         * @param reset Обнулить счётчики после снятия снимка
+         * @return Снимок статистики
+         */
+        [[nodiscard]] HandlerProfile snapshot(const bool reset = false) const noexcept
+        {
+            HandlerProfile result;
+            result.calls = take(mCalls, reset);
+            result.totalCycles = take(mTotalCycles, reset);
+            result.maxCycles = take(mMaxCycles, reset);
+            result.slowCalls = take(mSlowCalls, reset);
+            return result;
+        }
+
+    private:
+        template <typename U>
+        static U take(std::atomic<U>& counter, const bool reset) noexcept
+        {
+            return reset ? counter.exchange(0, std::memory_order_relaxed) : counter.load(std::memory_order_relaxed);
+        }
+
+        void assign(const HandlerProfile& profile) noexcept
+        {
+            mCalls.store(profile.calls, std::memory_order_relaxed);
+            mTotalCycles.store(profile.totalCycles, std::memory_order_relaxed);
+            mMaxCycles.store(profile.maxCycles, std::memory_order_relaxed);
+            mSlowCalls.store(profile.slowCalls, std::memory_order_relaxed);
+        }
+
+        mutable std::atomic<uint32_t> mCalls{0};       ///< Количество вызовов
+        mutable std::atomic<uint64_t> mTotalCycles{0}; ///< Суммарное время
+        mutable std::atomic<uint32_t> mMaxCycles{0};   ///< Максимальное время
+        mutable std::atomic<uint32_t> mSlowCalls{0};   ///< Медленные вызовы
+    };
+
+    /**
+     * @brief Пустая заглушка статистики (ENABLE_CALLBACK_PROFILING не задан)
+     */
+    class NoHandlerStats
+    {
+    public:
+        [[nodiscard]] static constexpr uint32_t now() noexcept { return 0; }
+        static constexpr bool onCall(uint32_t, uint32_t) noexcept { return false; }
+        [[nodiscard]] static constexpr HandlerProfile snapshot(bool = false) noexcept { return {}; }
+    };
+
+    /// @brief Тип статистики, используемый Callback
+    using HandlerStatsType = std::conditional_t<CALLBACK_PROFILING_ENABLED, HandlerStats, NoHandlerStats>;
+} // namespace esp32_c3::objects
+
+#endif // ESP32_C3_UTILS_HANDLER_STATS_H
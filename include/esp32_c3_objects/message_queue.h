@@ -0,0 +1,298 @@
+#ifndef ESP32_C3_UTILS_MESSAGE_QUEUE_H
+#define ESP32_C3_UTILS_MESSAGE_QUEUE_H
+
+#include "queue.h"
+#include "esp32_c3_utils/type_utils.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+
+namespace esp32_c3::objects
+{
+    /**
+     * @brief Очередь сообщений переменной длины на кольцевом байтовом буфере
+     * @tparam Header Тип заголовка сообщения (тривиально копируемый, выравнивание не более 4 байт)
+     * @tparam Capacity Размер кольцевого буфера в байтах (кратен 4)
+     * @details Каждое сообщение хранится непрерывно: служебная длина, заголовок Header и полезные данные.
+     * Память расходуется по фактическому размеру сообщения, а не по худшему случаю.
+     * Потребитель читает сообщение прямо из буфера (без копирования) и освобождает его вызовом release().
+     * Отправителей может быть несколько (сериализуются мьютексом), потребитель - один.
+     */
+    template <typename Header, size_t Capacity>
+    class MessageQueue
+    {
+        static_assert(std::is_trivially_copyable_v<Header>, "Message header must be trivially copyable");
+        static_assert(alignof(Header) <= 4, "Message header alignment must not exceed 4 bytes");
+        static_assert(Capacity % 4 == 0, "Capacity must be a multiple of 4");
+        static_assert(Capacity / 2 >= sizeof(uint32_t) + (sizeof(Header) + 3) / 4 * 4 + 4,
+                      "Capacity is too small for the message header");
+
+    public:
+        /**
+         * @brief Сообщение, прочитанное из очереди (ссылается на кольцевой буфер)
+         */
+        struct Message
+        {
+            const Header* header = nullptr;     ///< Заголовок сообщения
+            std::span<const uint8_t> payload{}; ///< Полезные данные
+        };
+
+        /// @brief Максимальный размер полезных данных одного сообщения
+        static constexpr size_t MAX_PAYLOAD = (Capacity / 2 - sizeof(uint32_t) - (sizeof(Header) + 3) / 4 * 4) / 4 * 4;
+
+        MessageQueue() noexcept :
+            mMessages(xSemaphoreCreateCounting(MAX_MESSAGES, 0)),
+            mSpaceFreed(xSemaphoreCreateBinary()),
+            mWriteLock(xSemaphoreCreateMutex())
+        {
+            if (!isValid())
+            {
+                ESP_LOGE((utils::generateTag<MessageQueue<Header, Capacity>>()), "Message queue creation failed");
+            }
+        }
+
+        ~MessageQueue() noexcept
+        {
+            if (mMessages) vSemaphoreDelete(mMessages);
+            if (mSpaceFreed) vSemaphoreDelete(mSpaceFreed);
+            if (mWriteLock) vSemaphoreDelete(mWriteLock);
+        }
+
+        // Запрет копирования и перемещения (сообщения ссылаются на внутренний буфер)
+        MessageQueue(const MessageQueue&) = delete;
+        MessageQueue& operator=(const MessageQueue&) = delete;
+
+        /**
+         * @brief Проверка валидности очереди
+         * @return true если все объекты ядра созданы успешно
+         */
+        [[nodiscard]] bool isValid() const noexcept
+        {
+            return mMessages && mSpaceFreed && mWriteLock;
+        }
+
+        /**
+         * @brief Отправить сообщение
+         * @param header Заголовок сообщения
+         * @param payload Полезные данные (не более MAX_PAYLOAD байт)
+         * @param ticksToWait Время ожидания свободного места
+         * @return true если успешно
+         */
+        bool send(const Header& header, const std::span<const uint8_t> payload,
+                  TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            if (!isValid() || payload.size() > MAX_PAYLOAD) return false;
+
+            TimeOut_t timeOut;
+            vTaskSetTimeOutState(&timeOut);
+
+            const size_t length = recordLength(payload.size());
+            while (true)
+            {
+                if (xSemaphoreTake(mWriteLock, ticksToWait) != pdTRUE) return false;
+
+                // Счётчик увеличивается под мьютексом: clear() между записью и сигналом
+                // оставил бы в счётчике сообщение без записи в буфере
+                const bool written = tryWrite(header, payload, length);
+                if (written) xSemaphoreGive(mMessages);
+                xSemaphoreGive(mWriteLock);
+
+                if (written) return true;
+
+                // Ожидание места выполняется без мьютекса, чтобы не блокировать clear()
+                if (xTaskCheckForTimeOut(&timeOut, &ticksToWait) != pdFALSE ||
+                    xSemaphoreTake(mSpaceFreed, ticksToWait) != pdTRUE)
+                {
+                    return false;
+                }
+            }
+        }
+
+        /**
+         * @brief Получить сообщение без копирования
+         * @param message Ссылка для сохранения сообщения (действительно до release())
+         * @param ticksToWait Время ожидания
+         * @return Результат операции receive
+         * @note Если предыдущее сообщение не было освобождено, оно освобождается автоматически
+         */
+        [[nodiscard]] QueueReceiveResult receive(Message& message, const TickType_t ticksToWait = portMAX_DELAY) noexcept
+        {
+            if (!isValid()) return QueueReceiveResult::QUEUE_ERROR;
+
+            release();
+
+            const BaseType_t result = xSemaphoreTake(mMessages, ticksToWait);
+
+            if (mAbortFlag.load())
+            {
+                mAbortFlag.store(false);
+                clear();
+                return QueueReceiveResult::ABORTED;
+            }
+
+            if (result != pdTRUE) return QueueReceiveResult::TIMEOUT;
+
+            size_t tail = mTail.load(std::memory_order_relaxed);
+            uint32_t size = readSize(tail);
+            if (size == WRAP_MARKER)
+            {
+                // Запись не поместилась в конец буфера и начинается с нуля.
+                // Позиция чтения сдвигается до уменьшения mUsed, как в release(): иначе отправитель
+                // увидел бы свободное место при старой позиции и перезаписал бы запись в начале буфера
+                const size_t skipped = Capacity - tail;
+                tail = 0;
+                mTail.store(tail, std::memory_order_release);
+                mUsed.fetch_sub(skipped, std::memory_order_release);
+                size = readSize(tail);
+            }
+
+            message.header = reinterpret_cast<const Header*>(&mBuffer[tail + sizeof(uint32_t)]);
+            message.payload = {&mBuffer[tail + sizeof(uint32_t) + HEADER_SPACE], size};
+            mPendingLength = recordLength(size);
+            return QueueReceiveResult::SUCCESS;
+        }
+
+        /**
+         * @brief Освободить место, занятое последним полученным сообщением
+         */
+        void release() noexcept
+        {
+            if (mPendingLength == 0) return;
+
+            size_t tail = mTail.load(std::memory_order_relaxed) + mPendingLength;
+            if (tail == Capacity) tail = 0;
+
+            mTail.store(tail, std::memory_order_release);
+            mUsed.fetch_sub(mPendingLength, std::memory_order_release);
+            mPendingLength = 0;
+            xSemaphoreGive(mSpaceFreed);
+        }
+
+        /**
+         * @brief Прервать блокирующую операцию receive и очистить очередь
+         * @return true если успешно
+         */
+        bool reset() noexcept
+        {
+            if (!isValid()) return false;
+
+            mAbortFlag.store(true);
+            return xSemaphoreGive(mMessages) == pdTRUE;
+        }
+
+        /// @brief Количество сообщений в очереди
+        [[nodiscard]] UBaseType_t messagesWaiting() const noexcept
+        {
+            return mMessages ? uxSemaphoreGetCount(mMessages) : 0;
+        }
+
+        /// @brief Количество свободных байт буфера (с учётом служебных данных)
+        [[nodiscard]] size_t bytesAvailable() const noexcept
+        {
+            return Capacity - mUsed.load(std::memory_order_relaxed);
+        }
+
+    private:
+        /// @brief Маркер перехода записи в начало буфера
+        static constexpr uint32_t WRAP_MARKER = UINT32_MAX;
+
+        /// @brief Место под заголовок с выравниванием до 4 байт
+        static constexpr size_t HEADER_SPACE = (sizeof(Header) + 3) / 4 * 4;
+
+        /// @brief Максимальное количество сообщений (для счётного семафора)
+        static constexpr UBaseType_t MAX_MESSAGES = Capacity / (sizeof(uint32_t) + HEADER_SPACE);
+
+        /// @brief Полный размер записи с выравниванием до 4 байт
+        static constexpr size_t recordLength(const size_t payloadSize) noexcept
+        {
+            return sizeof(uint32_t) + HEADER_SPACE + (payloadSize + 3) / 4 * 4;
+        }
+
+        [[nodiscard]] uint32_t readSize(const size_t position) const noexcept
+        {
+            uint32_t size;
+            std::memcpy(&size, &mBuffer[position], sizeof(size));
+            return size;
+        }
+
+        void writeRecord(const size_t position, const Header& header,
+                         const std::span<const uint8_t> payload) noexcept
+        {
+            const auto size = static_cast<uint32_t>(payload.size());
+            std::memcpy(&mBuffer[position], &size, sizeof(size));
+            std::memcpy(&mBuffer[position + sizeof(uint32_t)], &header, sizeof(Header));
+            if (!payload.empty())
+            {
+                std::memcpy(&mBuffer[position + sizeof(uint32_t) + HEADER_SPACE], payload.data(), payload.size());
+            }
+        }
+
+        /**
+         * @brief Записать сообщение, если для него есть непрерывное место (вызывается под mWriteLock)
+         * @return true если сообщение записано
+         */
+        bool tryWrite(const Header& header, const std::span<const uint8_t> payload, const size_t length) noexcept
+        {
+            const size_t used = mUsed.load(std::memory_order_acquire);
+            if (used == Capacity) return false;
+
+            const size_t head = mHead;
+            const size_t tail = mTail.load(std::memory_order_acquire);
+            const size_t freeAtEnd = head >= tail ? Capacity - head : tail - head;
+            const size_t freeAtStart = head >= tail ? tail : 0;
+
+            size_t position = head;
+            size_t consumed = length;
+            if (length > freeAtEnd)
+            {
+                if (length > freeAtStart) return false;
+
+                // Остаток в конце буфера пропускается, запись начинается с нуля
+                const uint32_t marker = WRAP_MARKER;
+                std::memcpy(&mBuffer[head], &marker, sizeof(marker));
+                position = 0;
+                consumed += freeAtEnd;
+            }
+
+            writeRecord(position, header, payload);
+
+            mHead = position + length == Capacity ? 0 : position + length;
+            mUsed.fetch_add(consumed, std::memory_order_release);
+            return true;
+        }
+
+        /// @brief Удалить все сообщения (после прерывания receive)
+        void clear() noexcept
+        {
+            xSemaphoreTake(mWriteLock, portMAX_DELAY);
+            xQueueReset(mMessages);
+            mTail.store(mHead, std::memory_order_release);
+            mUsed.store(0, std::memory_order_release);
+            mPendingLength = 0;
+            xSemaphoreGive(mWriteLock);
+            xSemaphoreGive(mSpaceFreed);
+        }
+
+        alignas(4) std::array<uint8_t, Capacity> mBuffer{}; ///< Кольцевой буфер
+        size_t mHead = 0;                                   ///< Позиция записи (под mWriteLock)
+        std::atomic<size_t> mTail{0};                       ///< Позиция чтения
+        std::atomic<size_t> mUsed{0};                       ///< Занято байт (включая пропуски в конце)
+        size_t mPendingLength = 0;                          ///< Размер полученного, но не освобождённого сообщения
+
+        SemaphoreHandle_t mMessages = nullptr;   ///< Счётчик сообщений
+        SemaphoreHandle_t mSpaceFreed = nullptr; ///< Сигнал освобождения места
+        SemaphoreHandle_t mWriteLock = nullptr;  ///< Мьютекс отправителей
+        std::atomic<bool> mAbortFlag{false};     ///< Флаг прерывания receive
+    };
+} // namespace esp32_c3::objects
+
+#endif // ESP32_C3_UTILS_MESSAGE_QUEUE_H
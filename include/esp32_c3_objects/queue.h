@@ -2,9 +2,14 @@
 #define ESP32_C3_UTILS_QUEUE_H
 
 #include "esp32_c3_utils/type_utils.h"
+#include "queue_stats.h"
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <freertos/task.h>
+#include <array>
+#include <atomic>
+#include <span>
 #include <utility>
 #include <esp_log.h>
 #include <type_traits>
@@ -20,6 +25,63 @@ namespace esp32_c3::objects
         QUEUE_ERROR ///< Ошибка очереди (не валидный handle)
     };
 
+    /**
+     * @brief Отложенное переключение контекста для FromISR-операций
+     * @details Накапливает флаг pxHigherPriorityTaskWoken от всех операций, выполненных
+     * в обработчике прерывания, и вызывает portYIELD_FROM_ISR один раз при выходе из области видимости
+     */
+    class IsrYield
+    {
+    public:
+        IsrYield() noexcept = default;
+
+        ~IsrYield() noexcept
+        {
+            portYIELD_FROM_ISR(mWoken);
+        }
+
+        // Запрет копирования
+        IsrYield(const IsrYield&) = delete;
+        IsrYield& operator=(const IsrYield&) = delete;
+
+        /// @brief Флаг для передачи в FromISR-операции
+        [[nodiscard]] BaseType_t& woken() noexcept
+        {
+            return mWoken;
+        }
+
+    private:
+        BaseType_t mWoken = pdFALSE; ///< Разбужена задача с более высоким приоритетом
+    };
+
+    /**
+     * @brief Обработчик успешной отправки в очередь
+     * @details Позволяет потоку, который ждёт сразу много очередей без блокировки на каждой
+     * (например, CoroutineRuntime), просыпаться по отправке, а не опрашивать очереди
+     */
+    struct QueueSendHook
+    {
+        void (*onSend)(void* context) noexcept;                                             ///< Вызов из задачи
+        void (*onSendFromISR)(void* context, BaseType_t& higherPriorityTaskWoken) noexcept; ///< Вызов из прерывания
+        void* context;                                                                      ///< Контекст обработчика
+    };
+
+    /**
+     * @brief Статическое хранилище очереди FreeRTOS
+     * @tparam T Тип элементов очереди
+     * @tparam Length Максимальное количество элементов
+     * @details Объявленное как глобальный или статический объект, размещается в .bss,
+     * и очередь создаётся без обращения к куче (xQueueCreateStatic)
+     */
+    template <typename T, UBaseType_t Length>
+    struct QueueStorage
+    {
+        static_assert(Length > 0, "Queue length must be greater than zero");
+
+        StaticQueue_t control;                                 ///< Управляющая структура очереди
+        alignas(QueueElement<T>) std::array<uint8_t, Length * sizeof(QueueElement<T>)> data; ///< Элементы
+    };
+
     /**
      * @brief Типобезопасная обертка для очереди FreeRTOS
      * @tparam T Тип элементов очереди (должен быть тривиально копируемым)
@@ -37,7 +99,7 @@ namespace esp32_c3::objects
             static_assert(std::is_trivially_copyable_v<T>,
                           "Queue elements must be trivially copyable");
 
-            mHandle = xQueueCreate(queueLength, sizeof(T));
+            mHandle = xQueueCreate(queueLength, sizeof(Element));
             if (mHandle == nullptr)
             {
                 ESP_LOGE(utils::generateTag<Queue<T>>(), "Queue creation failed (length=%u, size=%zu)",
@@ -49,6 +111,29 @@ namespace esp32_c3::objects
             }
         }
 
+        /**
+         * @brief Конструктор очереди на статическом хранилище (без выделения памяти в куче)
+         * @tparam Length Максимальное количество элементов
+         * @param storage Хранилище очереди (должно существовать дольше очереди)
+         */
+        template <UBaseType_t Length>
+        explicit Queue(QueueStorage<T, Length>& storage) noexcept
+        {
+            static_assert(std::is_trivially_copyable_v<T>,
+                          "Queue elements must be trivially copyable");
+
+            mHandle = xQueueCreateStatic(Length, sizeof(Element), storage.data.data(), &storage.control);
+            if (mHandle == nullptr)
+            {
+                ESP_LOGE(utils::generateTag<Queue<T>>(), "Static queue creation failed (length=%u, size=%zu)",
+                         Length, sizeof(T));
+            }
+            else
+            {
+                ESP_LOGD(utils::generateTag<Queue<T>>(), "Static queue created (length=%u)", Length);
+            }
+        }
+
         ~Queue() noexcept
         {
             cleanup();
@@ -61,7 +146,8 @@ namespace esp32_c3::objects
         // Поддержка перемещения
         Queue(Queue&& other) noexcept :
             mHandle(std::exchange(other.mHandle, nullptr)),
-            mAbortFlag(other.mAbortFlag.load())
+            mAbortFlag(other.mAbortFlag.load()),
+            mSendHook(other.mSendHook.exchange(nullptr))
         {
         }
 
@@ -72,6 +158,7 @@ namespace esp32_c3::objects
                 cleanup();
                 mHandle = std::exchange(other.mHandle, nullptr);
                 mAbortFlag = other.mAbortFlag.load();
+                mSendHook = other.mSendHook.exchange(nullptr);
             }
             return *this;
         }
@@ -93,7 +180,10 @@ namespace esp32_c3::objects
          */
         bool send(const T& item, const TickType_t ticksToWait = 0) const noexcept
         {
-            return mHandle && xQueueSend(mHandle, &item, ticksToWait) == pdTRUE;
+            const auto& element = wrap(item);
+            const bool sent = mHandle && xQueueSend(mHandle, &element, ticksToWait) == pdTRUE;
+            recordSend(sent);
+            return sent;
         }
 
         /**
@@ -103,7 +193,54 @@ namespace esp32_c3::objects
          */
         bool overwrite(const T& item) const noexcept
         {
-            return mHandle && xQueueOverwrite(mHandle, &item) == pdTRUE;
+            const auto& element = wrap(item);
+            const bool sent = mHandle && xQueueOverwrite(mHandle, &element) == pdTRUE;
+            recordSend(sent);
+            return sent;
+        }
+
+        /**
+         * @brief Отправить элемент из обработчика прерывания
+         * @param item Элемент для отправки
+         * @param higherPriorityTaskWoken Флаг переключения контекста (только устанавливается, не сбрасывается)
+         * @return true если успешно
+         * @note Переключение контекста не выполняется: вызовите portYIELD_FROM_ISR или используйте IsrYield
+         */
+        bool sendFromISR(const T& item, BaseType_t& higherPriorityTaskWoken) const noexcept
+        {
+            const auto& element = wrap(item);
+            const bool sent = mHandle && xQueueSendFromISR(mHandle, &element, &higherPriorityTaskWoken) == pdTRUE;
+            recordSend(sent, &higherPriorityTaskWoken);
+            return sent;
+        }
+
+        /**
+         * @brief Перезаписать элемент из обработчика прерывания (для очередей длиной 1)
+         * @param item Новый элемент
+         * @param higherPriorityTaskWoken Флаг переключения контекста (только устанавливается, не сбрасывается)
+         * @return true если успешно
+         */
+        bool overwriteFromISR(const T& item, BaseType_t& higherPriorityTaskWoken) const noexcept
+        {
+            const auto& element = wrap(item);
+            const bool sent = mHandle &&
+                xQueueOverwriteFromISR(mHandle, &element, &higherPriorityTaskWoken) == pdTRUE;
+            recordSend(sent, &higherPriorityTaskWoken);
+            return sent;
+        }
+
+        /**
+         * @brief Получить элемент из обработчика прерывания без ожидания
+         * @param item Ссылка для сохранения элемента
+         * @param higherPriorityTaskWoken Флаг переключения контекста (только устанавливается, не сбрасывается)
+         * @return true если элемент получен
+         */
+        bool receiveFromISR(T& item, BaseType_t& higherPriorityTaskWoken) const noexcept
+        {
+            return mHandle && unwrap(item, [&](void* element)
+            {
+                return xQueueReceiveFromISR(mHandle, element, &higherPriorityTaskWoken) == pdTRUE;
+            });
         }
 
         /**
@@ -116,7 +253,10 @@ namespace esp32_c3::objects
         {
             if (!mHandle) return QueueReceiveResult::QUEUE_ERROR;
 
-            const BaseType_t result = xQueueReceive(mHandle, &item, ticksToWait);
+            const bool result = unwrap(item, [&](void* element)
+            {
+                return xQueueReceive(mHandle, element, ticksToWait) == pdTRUE;
+            });
 
             if (mAbortFlag.load())
             {
@@ -125,7 +265,108 @@ namespace esp32_c3::objects
                 return QueueReceiveResult::ABORTED;
             }
 
-            return result == pdTRUE ? QueueReceiveResult::SUCCESS : QueueReceiveResult::TIMEOUT;
+            return result ? QueueReceiveResult::SUCCESS : QueueReceiveResult::TIMEOUT;
+        }
+
+        /**
+         * @brief Отправить несколько элементов в очередь
+         * @param items Элементы для отправки (в порядке следования)
+         * @param ticksToWait Время ожидания места для каждого элемента
+         * @return Количество отправленных элементов (отправка прекращается на первой ошибке)
+         * @details Элементы, для которых есть место, копируются в одной критической секции:
+         * потребитель с более высоким приоритетом просыпается один раз на пачку, а не на каждый элемент.
+         * В критической секции допустимы только ISR-функции очереди, поэтому обработчик отправки
+         * вызывается после выхода из неё, один раз на пачку. Ожидание места выполняется вне секции
+         * @note Прерывания запрещены на время копирования пачки: не используйте с крупными элементами
+         */
+        size_t sendBatch(const std::span<const T> items, const TickType_t ticksToWait = 0) const noexcept
+        {
+            if (!mHandle) return 0;
+
+            size_t sent = 0;
+            while (sent < items.size())
+            {
+                BaseType_t woken = pdFALSE;
+                size_t copied = 0;
+
+                taskENTER_CRITICAL(&mBatchLock);
+                while (sent + copied < items.size())
+                {
+                    const auto& element = wrap(items[sent + copied]);
+                    if (xQueueSendFromISR(mHandle, &element, &woken) != pdTRUE) break;
+                    ++copied;
+                }
+                taskEXIT_CRITICAL(&mBatchLock);
+
+                sent += copied;
+                recordBatch(copied);
+                if (woken == pdTRUE) taskYIELD();
+
+                if (sent == items.size() || !send(items[sent], ticksToWait)) break;
+                ++sent;
+            }
+            return sent;
+        }
+
+        /**
+         * @brief Получить несколько элементов за одно пробуждение
+         * @param items Буфер для сохранения элементов
+         * @param minCount Минимальное количество элементов, которое ожидается в пределах ticksToWait
+         * @param ticksToWait Общее время ожидания первых minCount элементов
+         * @return Количество полученных элементов
+         * @note После получения minCount элементов забираются все уже доступные элементы
+         * (до размера буфера) без дополнительного ожидания
+         */
+        [[nodiscard]] size_t receiveBatch(const std::span<T> items,
+                                          const size_t minCount = 1,
+                                          TickType_t ticksToWait = portMAX_DELAY) const noexcept
+        {
+            TimeOut_t timeOut;
+            vTaskSetTimeOutState(&timeOut);
+
+            size_t received = 0;
+            while (received < items.size())
+            {
+                const bool mustWait = received < minCount;
+                if (mustWait && received > 0 && xTaskCheckForTimeOut(&timeOut, &ticksToWait) != pdFALSE)
+                {
+                    break;
+                }
+
+                if (receive(items[received], mustWait ? ticksToWait : 0) != QueueReceiveResult::SUCCESS)
+                {
+                    break;
+                }
+                ++received;
+            }
+            return received;
+        }
+
+        /**
+         * @brief Обработать все доступные элементы за одно пробуждение
+         * @tparam F Тип обработчика, вызываемого как func(const T&)
+         * @param func Обработчик элементов
+         * @param ticksToWait Время ожидания первого элемента
+         * @return Количество обработанных элементов
+         * @note Обрабатываются только элементы, находившиеся в очереди на момент получения первого,
+         * поэтому быстрый производитель не может удерживать потребителя бесконечно
+         */
+        template <typename F>
+        size_t drain(F&& func, const TickType_t ticksToWait = portMAX_DELAY) const noexcept
+        {
+            T item;
+            if (receive(item, ticksToWait) != QueueReceiveResult::SUCCESS) return 0;
+
+            size_t count = 1;
+            UBaseType_t pending = messagesWaiting();
+            func(static_cast<const T&>(item));
+
+            while (pending-- > 0 && receive(item, 0) == QueueReceiveResult::SUCCESS)
+            {
+                func(static_cast<const T&>(item));
+                ++count;
+            }
+            return count;
         }
 
         /**
@@ -139,7 +380,7 @@ namespace esp32_c3::objects
             mAbortFlag.store(true);
 
             // Отправляем любой элемент чтобы разблокировать ожидание
-            T dummy{};
+            Element dummy{};
             return xQueueSendToFront(mHandle, &dummy, 0) == pdTRUE;
         }
 
@@ -149,13 +390,150 @@ namespace esp32_c3::objects
             return mHandle ? uxQueueMessagesWaiting(mHandle) : 0;
         }
 
+        /// @brief Хэндл очереди FreeRTOS (для QueueSet и прямых вызовов API)
+        [[nodiscard]] QueueHandle_t handle() const noexcept
+        {
+            return mHandle;
+        }
+
         /// @brief Количество свободных мест
         [[nodiscard]] UBaseType_t spacesAvailable() const noexcept
         {
             return mHandle ? uxQueueSpacesAvailable(mHandle) : 0;
         }
 
+        /**
+         * @brief Зарегистрировать очередь в реестре статистики
+         * @param name Имя очереди (должно быть статической строкой)
+         * @note Без ENABLE_QUEUE_STATS ничего не делает
+         */
+        void registerStats(const char* name) noexcept
+        {
+            mStats.registerAs(name);
+        }
+
+        /**
+         * @brief Получить снимок статистики очереди
+         * @param reset Обнулить счётчики после снятия снимка
+         * @return Снимок статистики (пустой без ENABLE_QUEUE_STATS)
+         */
+        [[nodiscard]] QueueStatsSnapshot stats(const bool reset = false) const noexcept
+        {
+            return mStats.snapshot(reset);
+        }
+
+        /// @brief Учесть потерю элемента, произошедшую до отправки в очередь
+        void recordDrop() const noexcept
+        {
+            mStats.onDrop();
+        }
+
+        /**
+         * @brief Установить обработчик успешной отправки
+         * @param hook Обработчик (должен существовать, пока установлен)
+         * @return true если установлен этот обработчик (false - очередь уже занята другим)
+         * @note Обработчик вызывается после каждой успешной отправки через методы очереди,
+         * в том числе из прерывания. Отправка напрямую через handle() его не вызывает
+         */
+        bool attachSendHook(const QueueSendHook& hook) const noexcept
+        {
+            const QueueSendHook* expected = nullptr;
+            return mSendHook.compare_exchange_strong(expected, &hook) || expected == &hook;
+        }
+
+        /**
+         * @brief Снять обработчик успешной отправки
+         * @param hook Обработчик, установленный attachSendHook() (другой обработчик не снимается)
+         */
+        void detachSendHook(const QueueSendHook& hook) const noexcept
+        {
+            const QueueSendHook* expected = &hook;
+            mSendHook.compare_exchange_strong(expected, nullptr);
+        }
+
     private:
+        /// @brief Тип, хранимый в очереди FreeRTOS
+        using Element = QueueElement<T>;
+
+        /// @brief Подготовить элемент к отправке (с отметкой времени при включённой статистике)
+        static decltype(auto) wrap(const T& item) noexcept
+        {
+            if constexpr (QUEUE_STATS_ENABLED)
+            {
+                return Element{item, QueueStatsType::now()};
+            }
+            else
+            {
+                return (item);
+            }
+        }
+
+        /**
+         * @brief Получить элемент через операцию FreeRTOS с учётом статистики
+         * @param item Ссылка для сохранения элемента
+         * @param receiveOp Операция получения, принимающая адрес буфера элемента
+         * @return true если элемент получен
+         */
+        template <typename ReceiveOp>
+        bool unwrap(T& item, ReceiveOp&& receiveOp) const noexcept
+        {
+            if constexpr (QUEUE_STATS_ENABLED)
+            {
+                Element element;
+                if (!receiveOp(&element)) return false;
+                item = element.item;
+                mStats.onReceive(element.stamp);
+                return true;
+            }
+            else
+            {
+                return receiveOp(&item);
+            }
+        }
+
+        /**
+         * @brief Учесть результат отправки в статистике и вызвать обработчик отправки
+         * @param sent Элемент отправлен
+         * @param higherPriorityTaskWoken Флаг переключения контекста (nullptr - вызов из задачи)
+         */
+        void recordSend(const bool sent, BaseType_t* const higherPriorityTaskWoken = nullptr) const noexcept
+        {
+            if constexpr (QUEUE_STATS_ENABLED)
+            {
+                const UBaseType_t depth = !sent ? 0
+                                          : higherPriorityTaskWoken ? uxQueueMessagesWaitingFromISR(mHandle)
+                                          : uxQueueMessagesWaiting(mHandle);
+                mStats.onSend(sent, depth);
+            }
+
+            if (const QueueSendHook* hook = sent ? mSendHook.load(std::memory_order_acquire) : nullptr)
+            {
+                if (higherPriorityTaskWoken) hook->onSendFromISR(hook->context, *higherPriorityTaskWoken);
+                else hook->onSend(hook->context);
+            }
+        }
+
+        /**
+         * @brief Учесть пачку элементов, отправленных в критической секции
+         * @param count Количество отправленных элементов
+         * @note Статистика получает глубину очереди после всей пачки
+         */
+        void recordBatch(const size_t count) const noexcept
+        {
+            if (count == 0) return;
+
+            if constexpr (QUEUE_STATS_ENABLED)
+            {
+                const UBaseType_t depth = uxQueueMessagesWaiting(mHandle);
+                for (size_t i = 0; i < count; ++i) mStats.onSend(true, depth);
+            }
+
+            if (const QueueSendHook* hook = mSendHook.load(std::memory_order_acquire))
+            {
+                hook->onSend(hook->context);
+            }
+        }
+
         void cleanup() noexcept
         {
             if (mHandle)
@@ -168,6 +546,9 @@ namespace esp32_c3::objects
 
         QueueHandle_t mHandle = nullptr;
         mutable std::atomic<bool> mAbortFlag{false};
+        mutable std::atomic<const QueueSendHook*> mSendHook{nullptr}; ///< Обработчик успешной отправки
+        mutable portMUX_TYPE mBatchLock = portMUX_INITIALIZER_UNLOCKED; ///< Критическая секция sendBatch()
+        [[no_unique_address]] mutable QueueStatsType mStats; ///< Статистика (пустая без ENABLE_QUEUE_STATS)
     };
 } // namespace esp32_c3::objects
 
@@ -0,0 +1,147 @@
+#ifndef ESP32_C3_UTILS_QUEUE_SET_H
+#define ESP32_C3_UTILS_QUEUE_SET_H
+
+#include "queue.h"
+#include "buffered_queue.h"
+#include "esp32_c3_utils/type_utils.h"
+
+#include <array>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <esp_log.h>
+
+namespace esp32_c3::objects
+{
+    /**
+     * @brief Обертка для набора очередей FreeRTOS (ожидание сразу нескольких очередей)
+     * @tparam MaxSources Максимальное количество очередей в наборе
+     * @details Позволяет одному потоку обслуживать несколько Queue<T> и BufferedQueue<T, N>.
+     * select() возвращает номер источника, в котором появились данные; после этого элемент
+     * забирается из соответствующей очереди вызовом receive() с нулевым ожиданием.
+     * @note Добавлять в набор можно только пустые очереди. Набор должен существовать дольше
+     * своих очередей либо очереди должны быть опустошены до его уничтожения.
+     */
+    template <size_t MaxSources>
+    class QueueSet
+    {
+        static_assert(MaxSources > 0, "QueueSet must have at least one source");
+
+    public:
+        /// @brief Результат select() при истечении времени ожидания или ошибке
+        static constexpr int NONE = -1;
+
+        /**
+         * @brief Конструктор набора
+         * @param capacity Суммарная длина всех очередей, которые будут добавлены в набор
+         */
+        explicit QueueSet(const UBaseType_t capacity) noexcept :
+            mHandle(xQueueCreateSet(capacity))
+        {
+            if (mHandle == nullptr)
+            {
+                ESP_LOGE(utils::generateTag<QueueSet<MaxSources>>(), "Queue set creation failed (capacity=%u)",
+                         capacity);
+            }
+        }
+
+        ~QueueSet() noexcept
+        {
+            if (!mHandle) return;
+
+            for (size_t i = 0; i < mCount; ++i)
+            {
+                if (xQueueRemoveFromSet(mSources[i], mHandle) != pdPASS)
+                {
+                    ESP_LOGW(utils::generateTag<QueueSet<MaxSources>>(),
+                             "Source %u is not empty and stays bound to the deleted set", static_cast<unsigned>(i));
+                }
+            }
+            vQueueDelete(mHandle);
+        }
+
+        // Запрет копирования и перемещения (очереди хранят ссылку на набор)
+        QueueSet(const QueueSet&) = delete;
+        QueueSet& operator=(const QueueSet&) = delete;
+
+        /**
+         * @brief Проверка валидности набора
+         * @return true если набор создан успешно
+         */
+        [[nodiscard]] bool isValid() const noexcept
+        {
+            return mHandle != nullptr;
+        }
+
+        /**
+         * @brief Добавить очередь в набор
+         * @param queue Очередь (должна быть пустой)
+         * @return Номер источника для сравнения с результатом select() или NONE при ошибке
+         */
+        template <typename T>
+        int add(const Queue<T>& queue) noexcept
+        {
+            return addHandle(queue.handle());
+        }
+
+        /**
+         * @brief Добавить буферизированную очередь в набор
+         * @param queue Очередь (должна быть пустой)
+         * @return Номер источника для сравнения с результатом select() или NONE при ошибке
+         */
+        template <typename T, size_t BufferSize, FreeSlotTracking Tracking>
+        int add(const BufferedQueue<T, BufferSize, Tracking>& queue) noexcept
+        {
+            return addHandle(queue.handle());
+        }
+
+        /**
+         * @brief Дождаться появления данных в любой из очередей набора
+         * @param ticksToWait Время ожидания
+         * @return Номер источника с данными или NONE при истечении времени ожидания
+         */
+        [[nodiscard]] int select(const TickType_t ticksToWait = portMAX_DELAY) const noexcept
+        {
+            if (!mHandle) return NONE;
+
+            const QueueSetMemberHandle_t member = xQueueSelectFromSet(mHandle, ticksToWait);
+            if (member == nullptr) return NONE;
+
+            for (size_t i = 0; i < mCount; ++i)
+            {
+                if (mSources[i] == member) return static_cast<int>(i);
+            }
+            return NONE;
+        }
+
+        /// @brief Количество очередей в наборе
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return mCount;
+        }
+
+    private:
+        int addHandle(const QueueHandle_t handle) noexcept
+        {
+            if (!mHandle || !handle || mCount >= MaxSources)
+            {
+                ESP_LOGE(utils::generateTag<QueueSet<MaxSources>>(), "Cannot add source: invalid handle or set is full");
+                return NONE;
+            }
+
+            if (xQueueAddToSet(handle, mHandle) != pdPASS)
+            {
+                ESP_LOGE(utils::generateTag<QueueSet<MaxSources>>(), "Cannot add source: queue is not empty");
+                return NONE;
+            }
+
+            mSources[mCount] = handle;
+            return static_cast<int>(mCount++);
+        }
+
+        QueueSetHandle_t mHandle = nullptr;                        ///< Хэндл набора FreeRTOS
+        std::array<QueueSetMemberHandle_t, MaxSources> mSources{}; ///< Очереди набора
+        size_t mCount = 0;                                         ///< Количество очередей в наборе
+    };
+} // namespace esp32_c3::objects
+
+#endif // ESP32_C3_UTILS_QUEUE_SET_H
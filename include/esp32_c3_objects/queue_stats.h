@@ -0,0 +1,252 @@
+#ifndef ESP32_C3_UTILS_QUEUE_STATS_H
+#define ESP32_C3_UTILS_QUEUE_STATS_H
+
+/**
+ * @file queue_stats.h
+ * @brief Инструментирование очередей: глубина, потери, гистограмма задержек
+ * @details Сбор статистики включается макросом ENABLE_QUEUE_STATS (например, -D ENABLE_QUEUE_STATS).
+ * Без него очереди используют пустую заглушку NoQueueStats, и инструментирование ничего не стоит.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <type_traits>
+
+#include <esp_cpu.h>
+#include <freertos/FreeRTOS.h>
+
+namespace esp32_c3::objects
+{
+#ifdef ENABLE_QUEUE_STATS
+    /// @brief Признак включённого сбора статистики очередей
+    constexpr bool QUEUE_STATS_ENABLED = true;
+#else
+    /// @brief Признак включённого сбора статистики очередей
+    constexpr bool QUEUE_STATS_ENABLED = false;
+#endif
+
+    /// @brief Количество корзин гистограммы задержек (корзина i: задержка в [2^i, 2^(i+1)) тактов)
+    constexpr size_t QUEUE_LATENCY_BUCKETS = 32;
+
+    /**
+     * @brief Снимок статистики очереди
+     */
+    struct QueueStatsSnapshot
+    {
+        const char* name = nullptr;                               ///< Имя, заданное при регистрации
+        uint32_t maxDepth = 0;                                    ///< Максимальная глубина очереди
+        uint32_t sent = 0;                                        ///< Успешно отправлено элементов
+        uint32_t received = 0;                                    ///< Получено элементов
+        uint32_t dropped = 0;                                     ///< Неудачные отправки (таймаут, нет места)
+        std::array<uint32_t, QUEUE_LATENCY_BUCKETS> latency = {}; ///< Задержка от отправки до получения
+    };
+
+    /**
+     * @brief Элемент очереди с отметкой времени отправки (используется при включённой статистике)
+     * @tparam T Тип элемента
+     */
+    template <typename T>
+    struct StampedElement
+    {
+        T item;         ///< Элемент
+        uint32_t stamp; ///< Значение счётчика тактов в момент отправки
+    };
+
+    /// @brief Тип, хранимый в очереди FreeRTOS для элементов T
+    template <typename T>
+    using QueueElement = std::conditional_t<QUEUE_STATS_ENABLED, StampedElement<T>, T>;
+
+    /**
+     * @brief Счётчики статистики одной очереди и глобальный реестр зарегистрированных очередей
+     */
+    class QueueStats
+    {
+    public:
+        QueueStats() noexcept = default;
+
+        ~QueueStats() noexcept
+        {
+            unregister();
+        }
+
+        // Запрет копирования (объект входит в реестр по адресу)
+        QueueStats(const QueueStats&) = delete;
+        QueueStats& operator=(const QueueStats&) = delete;
+
+        /// @brief Текущее значение счётчика тактов для отметки времени
+        [[nodiscard]] static uint32_t now() noexcept
+        {
+            return static_cast<uint32_t>(esp_cpu_get_cycle_count());
+        }
+
+        /**
+         * @brief Учесть попытку отправки
+         * @param success Результат отправки
+         * @param depth Глубина очереди после отправки
+         */
+        void onSend(const bool success, const UBaseType_t depth) noexcept
+        {
+            if (!success)
+            {
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            mSent.fetch_add(1, std::memory_order_relaxed);
+            uint32_t current = mMaxDepth.load(std::memory_order_relaxed);
+            while (depth > current &&
+                !mMaxDepth.compare_exchange_weak(current, depth, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        /// @brief Учесть потерю элемента вне очереди FreeRTOS (например, нет свободного слота буфера)
+        void onDrop() noexcept
+        {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Учесть получение элемента
+         * @param stamp Отметка времени отправки
+         */
+        void onReceive(const uint32_t stamp) noexcept
+        {
+            mReceived.fetch_add(1, std::memory_order_relaxed);
+            const uint32_t cycles = now() - stamp;
+            const size_t bucket = cycles == 0 ? 0 : 31 - static_cast<size_t>(__builtin_clz(cycles));
+            mLatency[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Получить снимок статистики
+         * @param reset Обнулить счётчики после снятия снимка
+         * @return Снимок статистики
+         */
+        [[nodiscard]] QueueStatsSnapshot snapshot(const bool reset = false) noexcept
+        {
+            QueueStatsSnapshot result;
+            result.name = mName;
+            result.maxDepth = take(mMaxDepth, reset);
+            result.sent = take(mSent, reset);
+            result.received = take(mReceived, reset);
+            result.dropped = take(mDropped, reset);
+            for (size_t i = 0; i < QUEUE_LATENCY_BUCKETS; ++i)
+            {
+                result.latency[i] = take(mLatency[i], reset);
+            }
+            return result;
+        }
+
+        /**
+         * @brief Зарегистрировать очередь в глобальном реестре
+         * @param name Имя очереди (должно быть статической строкой)
+         */
+        void registerAs(const char* name) noexcept
+        {
+            std::lock_guard lock(registryMutex());
+            mName = name;
+            if (mRegistered) return;
+
+            mNext = registryHead();
+            registryHead() = this;
+            mRegistered = true;
+        }
+
+        /// @brief Удалить очередь из глобального реестра
+        void unregister() noexcept
+        {
+            std::lock_guard lock(registryMutex());
+            if (!mRegistered) return;
+
+            for (QueueStats** link = &registryHead(); *link; link = &(*link)->mNext)
+            {
+                if (*link == this)
+                {
+                    *link = mNext;
+                    break;
+                }
+            }
+            mNext = nullptr;
+            mRegistered = false;
+        }
+
+        /**
+         * @brief Получить снимки статистики всех зарегистрированных очередей
+         * @param out Буфер для снимков
+         * @param reset Обнулить счётчики после снятия снимков
+         * @return Количество записанных снимков
+         */
+        static size_t snapshotAll(const std::span<QueueStatsSnapshot> out, const bool reset = false) noexcept
+        {
+            std::lock_guard lock(registryMutex());
+            size_t count = 0;
+            for (QueueStats* stats = registryHead(); stats && count < out.size(); stats = stats->mNext)
+            {
+                out[count++] = stats->snapshot(reset);
+            }
+            return count;
+        }
+
+        /// @brief Обнулить статистику всех зарегистрированных очередей
+        static void resetAll() noexcept
+        {
+            std::lock_guard lock(registryMutex());
+            for (QueueStats* stats = registryHead(); stats; stats = stats->mNext)
+            {
+                (void)stats->snapshot(true);
+            }
+        }
+
+    private:
+        static uint32_t take(std::atomic<uint32_t>& counter, const bool reset) noexcept
+        {
+            return reset ? counter.exchange(0, std::memory_order_relaxed) : counter.load(std::memory_order_relaxed);
+        }
+
+        static QueueStats*& registryHead() noexcept
+        {
+            static QueueStats* head = nullptr;
+            return head;
+        }
+
+        static std::mutex& registryMutex() noexcept
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::atomic<uint32_t> mMaxDepth{0};                                  ///< Максимальная глубина
+        std::atomic<uint32_t> mSent{0};                                      ///< Отправлено
+        std::atomic<uint32_t> mReceived{0};                                  ///< Получено
+        std::atomic<uint32_t> mDropped{0};                                   ///< Потеряно
+        std::array<std::atomic<uint32_t>, QUEUE_LATENCY_BUCKETS> mLatency{}; ///< Гистограмма задержек
+
+        const char* mName = nullptr; ///< Имя в реестре
+        QueueStats* mNext = nullptr; ///< Следующий элемент реестра
+        bool mRegistered = false;    ///< Флаг регистрации
+    };
+
+    /**
+     * @brief Пустая заглушка статистики (ENABLE_QUEUE_STATS не задан)
+     */
+    class NoQueueStats
+    {
+    public:
+        [[nodiscard]] static constexpr uint32_t now() noexcept { return 0; }
+        static constexpr void onSend(bool, UBaseType_t) noexcept {}
+        static constexpr void onDrop() noexcept {}
+        static constexpr void onReceive(uint32_t) noexcept {}
+        [[nodiscard]] static QueueStatsSnapshot snapshot(bool = false) noexcept { return {}; }
+        static constexpr void registerAs(const char*) noexcept {}
+        static constexpr void unregister() noexcept {}
+    };
+
+    /// @brief Тип статистики, используемый очередями
+    using QueueStatsType = std::conditional_t<QUEUE_STATS_ENABLED, QueueStats, NoQueueStats>;
+} // namespace esp32_c3::objects
+
+#endif // ESP32_C3_UTILS_QUEUE_STATS_H
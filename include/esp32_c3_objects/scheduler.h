@@ -0,0 +1,526 @@
+#ifndef ESP32_C3_UTILS_SCHEDULER_H
+#define ESP32_C3_UTILS_SCHEDULER_H
+
+#include "thread.h"
+#include "esp32_c3_utils/type_utils.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+
+namespace esp32_c3::objects
+{
+    /**
+     * @brief Кооперативный планировщик периодических задач в одном потоке
+     * @tparam MaxJobs Максимальное количество задач
+     * @details Все задачи выполняются по очереди на стеке одного Thread, поэтому дюжина мелких
+     * периодических задач расходует один стек вместо дюжины. Сроки задач хранятся в двоичной куче,
+     * и поток спит ровно до ближайшего срока. Как и Thread::startPeriodic(), расписание отсчитывается
+     * от предыдущего срока, а пропущенные периоды не догоняются.
+     * Результат функции задачи управляет только этой задачей:
+     * LoopAction::PAUSE приостанавливает её до resume(), LoopAction::STOP удаляет её из планировщика.
+     * @note Задачи кооперативны: функция, которая блокируется, задерживает все остальные задачи
+     */
+    template <size_t MaxJobs>
+    class Scheduler
+    {
+        static_assert(MaxJobs > 0 && MaxJobs < INT16_MAX, "Scheduler must have between 1 and 32766 jobs");
+
+    public:
+        using LoopAction = Thread::LoopAction;
+        using LoopFunc = Thread::LoopFunc;
+
+        /// @brief Идентификатор задачи (номер слота)
+        using JobId = int16_t;
+
+        /// @brief Идентификатор, возвращаемый при ошибке
+        static constexpr JobId INVALID_JOB = -1;
+
+        /// @brief Размер стека по умолчанию
+        static constexpr uint32_t DEFAULT_STACK_DEPTH = 3072;
+
+        /// @brief Приоритет по умолчанию
+        static constexpr UBaseType_t DEFAULT_PRIORITY = 5;
+
+        /// @brief Состояния задачи
+        enum class JobState : uint8_t
+        {
+            FREE,   ///< Слот свободен
+            ACTIVE, ///< Задача ожидает своего срока или выполняется
+            PAUSED  ///< Задача приостановлена
+        };
+
+        /**
+         * @brief Конструктор планировщика
+         * @param name Имя потока
+         * @param stackDepth Размер стека потока
+         * @param priority Приоритет потока
+         */
+        explicit Scheduler(const std::string_view name,
+                           const uint32_t stackDepth = DEFAULT_STACK_DEPTH,
+                           const UBaseType_t priority = DEFAULT_PRIORITY) noexcept :
+            mThread(name, stackDepth, priority)
+        {
+            init();
+        }
+
+        /**
+         * @brief Конструктор планировщика на статическом хранилище потока
+         * @tparam StackDepth Размер стека
+         * @param name Имя потока
+         * @param storage Хранилище стека и TCB (должно существовать дольше планировщика)
+         * @param priority Приоритет потока
+         */
+        template <uint32_t StackDepth>
+        Scheduler(const std::string_view name, ThreadStorage<StackDepth>& storage,
+                  const UBaseType_t priority = DEFAULT_PRIORITY) noexcept :
+            mThread(name, storage, priority)
+        {
+            init();
+        }
+
+        ~Scheduler() noexcept
+        {
+            stop();
+            if (mLock) vSemaphoreDelete(mLock);
+            if (mWake) vSemaphoreDelete(mWake);
+        }
+
+        // Запрет копирования и перемещения (поток ссылается на объект)
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        /**
+         * @brief Проверка инициализации
+         * @return true если объекты синхронизации созданы
+         */
+        [[nodiscard]] bool isInitialized() const noexcept
+        {
+            return mLock && mWake;
+        }
+
+        /**
+         * @brief Запуск потока планировщика
+         * @return true если поток запущен или уже работает
+         */
+        bool start() noexcept
+        {
+            if (!isInitialized()) return false;
+
+            mStopRequested.store(false, std::memory_order_relaxed);
+            return mThread.quickStart([this] { return runOnce(); }, Thread::LoopMode::EVENT_DRIVEN);
+        }
+
+        /**
+         * @brief Остановка потока планировщика
+         * @note Задачи сохраняются и продолжат выполняться после следующего start()
+         */
+        void stop() noexcept
+        {
+            if (!isInitialized()) return;
+
+            mStopRequested.store(true, std::memory_order_relaxed);
+            xSemaphoreGive(mWake);
+            mThread.stop();
+        }
+
+        /**
+         * @brief Добавить задачу
+         * @param func Функция задачи
+         * @param intervalMs Период выполнения в миллисекундах
+         * @param startPaused Добавить в приостановленном состоянии
+         * @return Идентификатор задачи или INVALID_JOB, если свободных слотов нет
+         * @note Первый запуск выполняется сразу (как у Thread::start())
+         */
+        [[nodiscard]] JobId addJob(LoopFunc func, const uint32_t intervalMs, const bool startPaused = false) noexcept
+        {
+            if (!isInitialized() || !func) return INVALID_JOB;
+
+            const TickType_t interval = pdMS_TO_TICKS(intervalMs);
+            if (!lock()) return INVALID_JOB;
+
+            JobId id = INVALID_JOB;
+            for (size_t i = 0; i < MaxJobs; ++i)
+            {
+                if (mJobs[i].state == JobState::FREE)
+                {
+                    id = static_cast<JobId>(i);
+                    break;
+                }
+            }
+
+            if (id != INVALID_JOB)
+            {
+                Job& job = mJobs[id];
+                job.func = std::move(func);
+                job.interval = interval > 0 ? interval : 1;
+                job.deadline = xTaskGetTickCount();
+                job.state = startPaused ? JobState::PAUSED : JobState::ACTIVE;
+                if (!startPaused) push(id);
+            }
+
+            xSemaphoreGive(mLock);
+
+            if (id == INVALID_JOB)
+            {
+                ESP_LOGE((utils::generateTag<Scheduler<MaxJobs>>()), "No free job slots (max %u)",
+                         static_cast<unsigned>(MaxJobs));
+                return INVALID_JOB;
+            }
+
+            xSemaphoreGive(mWake);
+            return id;
+        }
+
+        /**
+         * @brief Приостановить задачу
+         * @param id Идентификатор задачи
+         * @return true если задача была активна
+         * @note Выполняющаяся задача приостанавливается после возврата из функции
+         */
+        bool pause(const JobId id) noexcept
+        {
+            return update(id, [this](Job& job, const JobId jobId)
+            {
+                if (job.state != JobState::ACTIVE) return false;
+
+                job.state = JobState::PAUSED;
+                if (jobId != mRunning) erase(jobId);
+                return true;
+            });
+        }
+
+        /**
+         * @brief Возобновить приостановленную задачу
+         * @param id Идентификатор задачи
+         * @return true если задача была приостановлена
+         * @note Задача выполняется сразу, далее - со своим периодом
+         */
+        bool resume(const JobId id) noexcept
+        {
+            const bool resumed = update(id, [this](Job& job, const JobId jobId)
+            {
+                if (job.state != JobState::PAUSED) return false;
+
+                job.state = JobState::ACTIVE;
+                job.deadline = xTaskGetTickCount();
+                if (jobId != mRunning) push(jobId);
+                return true;
+            });
+
+            if (resumed) xSemaphoreGive(mWake);
+            return resumed;
+        }
+
+        /**
+         * @brief Удалить задачу
+         * @param id Идентификатор задачи
+         * @return true если задача существовала
+         * @note Выполняющаяся задача удаляется после возврата из функции
+         */
+        bool remove(const JobId id) noexcept
+        {
+            // Функция задачи уничтожается после снятия блокировки
+            LoopFunc finished;
+            const bool removed = update(id, [this, &finished](Job& job, const JobId jobId)
+            {
+                if (job.state == JobState::FREE) return false;
+
+                if (jobId == mRunning)
+                {
+                    job.removeRequested = true;
+                    return true;
+                }
+
+                if (job.state == JobState::ACTIVE) erase(jobId);
+                finished = release(job);
+                return true;
+            });
+            return removed;
+        }
+
+        /**
+         * @brief Изменить период задачи
+         * @param id Идентификатор задачи
+         * @param intervalMs Новый период в миллисекундах (действует со следующего срока)
+         * @return true если задача существует
+         */
+        bool setInterval(const JobId id, const uint32_t intervalMs) noexcept
+        {
+            const TickType_t interval = pdMS_TO_TICKS(intervalMs);
+            return update(id, [interval](Job& job, JobId)
+            {
+                if (job.state == JobState::FREE) return false;
+
+                job.interval = interval > 0 ? interval : 1;
+                return true;
+            });
+        }
+
+        /**
+         * @brief Получить состояние задачи
+         * @param id Идентификатор задачи
+         * @return Состояние задачи (FREE для неверного идентификатора)
+         */
+        [[nodiscard]] JobState jobState(const JobId id) const noexcept
+        {
+            if (!isValidId(id) || !isInitialized()) return JobState::FREE;
+
+            if (!lock()) return JobState::FREE;
+            const JobState state = mJobs[id].removeRequested ? JobState::FREE : mJobs[id].state;
+            xSemaphoreGive(mLock);
+            return state;
+        }
+
+        /**
+         * @brief Количество пропущенных периодов задачи
+         * @param id Идентификатор задачи
+         * @return Количество сроков, к которым предыдущее выполнение ещё не завершилось
+         */
+        [[nodiscard]] uint32_t overruns(const JobId id) const noexcept
+        {
+            if (!isValidId(id) || !isInitialized()) return 0;
+
+            if (!lock()) return 0;
+            const uint32_t result = mJobs[id].overruns;
+            xSemaphoreGive(mLock);
+            return result;
+        }
+
+        /// @brief Количество активных задач (ожидающих своего срока)
+        [[nodiscard]] size_t activeJobs() const noexcept
+        {
+            if (!isInitialized()) return 0;
+
+            if (!lock()) return 0;
+            const size_t count = mHeapSize + (mRunning != INVALID_JOB ? 1 : 0);
+            xSemaphoreGive(mLock);
+            return count;
+        }
+
+        /// @brief Поток, в котором выполняются задачи
+        [[nodiscard]] Thread& thread() noexcept
+        {
+            return mThread;
+        }
+
+    private:
+        /**
+         * @brief Задача планировщика
+         */
+        struct Job
+        {
+            LoopFunc func;                      ///< Функция задачи
+            TickType_t interval = 0;            ///< Период в тиках
+            TickType_t deadline = 0;            ///< Срок следующего выполнения
+            uint32_t overruns = 0;              ///< Пропущенные периоды
+            int16_t heapPos = INVALID_JOB;      ///< Позиция в куче (INVALID_JOB - не в куче)
+            JobState state = JobState::FREE;    ///< Состояние задачи
+            bool removeRequested = false;       ///< Удалить после завершения текущего выполнения
+        };
+
+        void init() noexcept
+        {
+            mLock = xSemaphoreCreateMutexStatic(&mLockBuffer);
+            mWake = xSemaphoreCreateBinaryStatic(&mWakeBuffer);
+            if (!isInitialized())
+            {
+                ESP_LOGE((utils::generateTag<Scheduler<MaxJobs>>()), "Scheduler creation failed");
+            }
+        }
+
+        /// @brief Захват mLock (false - мьютекс не получен, состояние не изменяется)
+        [[nodiscard]] bool lock() const noexcept
+        {
+            if (xSemaphoreTake(mLock, portMAX_DELAY) == pdTRUE) return true;
+
+            ESP_LOGE((utils::generateTag<Scheduler<MaxJobs>>()), "Failed to take scheduler lock");
+            return false;
+        }
+
+        [[nodiscard]] static constexpr bool isValidId(const JobId id) noexcept
+        {
+            return id >= 0 && static_cast<size_t>(id) < MaxJobs;
+        }
+
+        /// @brief Сравнение сроков с учётом переполнения счётчика тиков
+        [[nodiscard]] static bool earlier(const TickType_t a, const TickType_t b) noexcept
+        {
+            return static_cast<int32_t>(a - b) < 0;
+        }
+
+        /**
+         * @brief Изменить задачу под блокировкой
+         * @param id Идентификатор задачи
+         * @param action Действие над задачей, возвращающее признак успеха
+         * @return Результат действия (false для неверного идентификатора)
+         */
+        template <typename Action>
+        bool update(const JobId id, Action&& action) noexcept
+        {
+            if (!isValidId(id) || !isInitialized()) return false;
+
+            if (!lock()) return false;
+            Job& job = mJobs[id];
+            const bool result = !job.removeRequested && action(job, id);
+            xSemaphoreGive(mLock);
+            return result;
+        }
+
+        /// @brief Освободить слот задачи (под mLock), функция возвращается для уничтожения вне блокировки
+        LoopFunc release(Job& job) noexcept
+        {
+            LoopFunc func = std::move(job.func);
+            job.func = nullptr;
+            job.state = JobState::FREE;
+            job.overruns = 0;
+            job.removeRequested = false;
+            return func;
+        }
+
+        /**
+         * @brief Одна итерация потока: ожидание ближайшего срока и выполнение задачи
+         * @return Действие для цикла потока
+         */
+        LoopAction runOnce() noexcept
+        {
+            if (mStopRequested.load(std::memory_order_relaxed)) return LoopAction::STOP;
+
+            if (!lock()) return LoopAction::CONTINUE;
+            TickType_t wait = portMAX_DELAY;
+            if (mHeapSize > 0)
+            {
+                const TickType_t now = xTaskGetTickCount();
+                const TickType_t deadline = mJobs[mHeap[0]].deadline;
+                wait = earlier(now, deadline) ? deadline - now : 0;
+            }
+
+            if (wait > 0)
+            {
+                xSemaphoreGive(mLock);
+                // Добавление и возобновление задач будят поток досрочно
+                xSemaphoreTake(mWake, wait);
+                return LoopAction::CONTINUE;
+            }
+
+            const JobId id = mHeap[0];
+            erase(id);
+            mRunning = id;
+            xSemaphoreGive(mLock);
+
+            const LoopAction action = mJobs[id].func();
+
+            LoopFunc finished;
+            // Бесконечное ожидание мьютекса завершается ошибкой только при повреждённом мьютексе:
+            // тогда задача остаётся отмеченной как выполняющаяся и больше не планируется
+            if (!lock()) return LoopAction::CONTINUE;
+            mRunning = INVALID_JOB;
+
+            Job& job = mJobs[id];
+            if (job.removeRequested || action == LoopAction::STOP)
+            {
+                finished = release(job);
+            }
+            else if (action == LoopAction::PAUSE || job.state == JobState::PAUSED)
+            {
+                job.state = JobState::PAUSED;
+            }
+            else
+            {
+                job.deadline += job.interval;
+                if (const TickType_t now = xTaskGetTickCount(); !earlier(now, job.deadline))
+                {
+                    // Выполнение не уложилось в период: расписание продолжается от текущего тика
+                    job.deadline = now + job.interval;
+                    ++job.overruns;
+                }
+                push(id);
+            }
+            xSemaphoreGive(mLock);
+
+            return LoopAction::CONTINUE;
+        }
+
+        // Двоичная куча сроков (под mLock)
+
+        void place(const size_t pos, const JobId id) noexcept
+        {
+            mHeap[pos] = id;
+            mJobs[id].heapPos = static_cast<int16_t>(pos);
+        }
+
+        void siftUp(size_t pos) noexcept
+        {
+            const JobId id = mHeap[pos];
+            while (pos > 0)
+            {
+                const size_t parent = (pos - 1) / 2;
+                if (!earlier(mJobs[id].deadline, mJobs[mHeap[parent]].deadline)) break;
+                place(pos, mHeap[parent]);
+                pos = parent;
+            }
+            place(pos, id);
+        }
+
+        void siftDown(size_t pos) noexcept
+        {
+            const JobId id = mHeap[pos];
+            while (true)
+            {
+                size_t child = 2 * pos + 1;
+                if (child >= mHeapSize) break;
+                if (child + 1 < mHeapSize &&
+                    earlier(mJobs[mHeap[child + 1]].deadline, mJobs[mHeap[child]].deadline))
+                {
+                    ++child;
+                }
+                if (!earlier(mJobs[mHeap[child]].deadline, mJobs[id].deadline)) break;
+                place(pos, mHeap[child]);
+                pos = child;
+            }
+            place(pos, id);
+        }
+
+        void push(const JobId id) noexcept
+        {
+            place(mHeapSize, id);
+            siftUp(mHeapSize++);
+        }
+
+        void erase(const JobId id) noexcept
+        {
+            const int16_t pos = mJobs[id].heapPos;
+            if (pos == INVALID_JOB) return;
+
+            mJobs[id].heapPos = INVALID_JOB;
+            if (static_cast<size_t>(pos) == --mHeapSize) return;
+
+            // Последний элемент занимает освободившуюся позицию и всплывает или тонет
+            const JobId moved = mHeap[mHeapSize];
+            place(pos, moved);
+            siftDown(pos);
+            siftUp(mJobs[moved].heapPos);
+        }
+
+        Thread mThread; ///< Поток планировщика
+
+        std::array<Job, MaxJobs> mJobs{};   ///< Слоты задач
+        std::array<JobId, MaxJobs> mHeap{}; ///< Куча сроков активных задач
+        size_t mHeapSize = 0;               ///< Количество задач в куче
+        JobId mRunning = INVALID_JOB;       ///< Выполняющаяся задача
+
+        SemaphoreHandle_t mLock = nullptr;         ///< Мьютекс таблицы задач
+        SemaphoreHandle_t mWake = nullptr;         ///< Досрочное пробуждение потока
+        StaticSemaphore_t mLockBuffer{};           ///< Память мьютекса таблицы задач
+        StaticSemaphore_t mWakeBuffer{};           ///< Память семафора пробуждения
+        std::atomic<bool> mStopRequested{false};   ///< Запрос остановки потока
+    };
+} // namespace esp32_c3::objects
+
+#endif // ESP32_C3_UTILS_SCHEDULER_H
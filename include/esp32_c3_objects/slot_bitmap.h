@@ -0,0 +1,192 @@
+#ifndef ESP32_C3_UTILS_SLOT_BITMAP_H
+#define ESP32_C3_UTILS_SLOT_BITMAP_H
+
+#include "queue.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+namespace esp32_c3::objects
+{
+    /**
+     * @brief Атомарная битовая карта свободных слотов буфера
+     * @tparam Size Количество слотов
+     * @details Замена очереди свободных индексов: захват и возврат слота выполняются одной
+     * атомарной операцией над словом карты, конструирование не требует отправки Size элементов
+     * в очередь. Для ожидания свободного слота используется статический двоичный семафор,
+     * который возврат слота отдаёт только при наличии ожидающих задач. Интерфейс совместим
+     * с Queue<size_t> в той части, которая используется BufferedQueue.
+     * @note На ESP32-C3 (RV32IMC без расширения A) атомарные операции эмулируются коротким
+     * критическим участком, что всё равно значительно дешевле операции над очередью FreeRTOS.
+     */
+    template <size_t Size>
+    class SlotBitmap
+    {
+        static_assert(Size > 0, "SlotBitmap size must be greater than zero");
+
+    public:
+        SlotBitmap() noexcept :
+            mSlotFreed(xSemaphoreCreateBinaryStatic(&mSlotFreedBuffer))
+        {
+            for (size_t i = 0; i < WORDS; ++i)
+            {
+                mWords[i].store(wordMask(i), std::memory_order_relaxed);
+            }
+        }
+
+        ~SlotBitmap() noexcept
+        {
+            if (mSlotFreed) vSemaphoreDelete(mSlotFreed);
+        }
+
+        // Запрет копирования (семафор размещён в самом объекте)
+        SlotBitmap(const SlotBitmap&) = delete;
+        SlotBitmap& operator=(const SlotBitmap&) = delete;
+
+        /// @brief Проверка создания семафора ожидания
+        [[nodiscard]] bool isValid() const noexcept
+        {
+            return mSlotFreed != nullptr;
+        }
+
+        /**
+         * @brief Захватить свободный слот без ожидания
+         * @param index Ссылка для сохранения индекса слота
+         * @return true если слот захвачен
+         */
+        bool tryAcquire(size_t& index) const noexcept
+        {
+            for (size_t i = 0; i < WORDS; ++i)
+            {
+                uint32_t current = mWords[i].load(std::memory_order_relaxed);
+                while (current != 0)
+                {
+                    const uint32_t bit = current & (~current + 1); // Младший установленный бит
+                    if (mWords[i].compare_exchange_weak(current, current & ~bit,
+                                                        std::memory_order_acquire,
+                                                        std::memory_order_relaxed))
+                    {
+                        index = i * WORD_BITS + static_cast<size_t>(__builtin_ctz(bit));
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Захватить свободный слот (аналог Queue<size_t>::receive)
+         * @param index Ссылка для сохранения индекса слота
+         * @param ticksToWait Время ожидания
+         * @return Результат операции
+         * @details Ожидающая задача регистрируется в mWaiters до повторной проверки карты,
+         * а возврат слота проверяет mWaiters после установки бита: либо задача увидит слот,
+         * либо возврат отдаст семафор. Получив слот, задача передаёт сигнал следующей
+         * ожидающей, поскольку двоичный семафор не накапливает несколько возвратов
+         */
+        [[nodiscard]] QueueReceiveResult receive(size_t& index, TickType_t ticksToWait) const noexcept
+        {
+            if (tryAcquire(index)) return QueueReceiveResult::SUCCESS;
+            if (ticksToWait == 0) return QueueReceiveResult::TIMEOUT;
+            if (!mSlotFreed) return QueueReceiveResult::QUEUE_ERROR;
+
+            TimeOut_t timeOut;
+            vTaskSetTimeOutState(&timeOut);
+
+            mWaiters.fetch_add(1);
+            QueueReceiveResult result = QueueReceiveResult::TIMEOUT;
+            while (true)
+            {
+                if (tryAcquire(index))
+                {
+                    result = QueueReceiveResult::SUCCESS;
+                    break;
+                }
+                if (xTaskCheckForTimeOut(&timeOut, &ticksToWait) != pdFALSE) break;
+                (void)xSemaphoreTake(mSlotFreed, ticksToWait);
+            }
+
+            if (mWaiters.fetch_sub(1) > 1 && result == QueueReceiveResult::SUCCESS)
+            {
+                xSemaphoreGive(mSlotFreed);
+            }
+            return result;
+        }
+
+        /**
+         * @brief Вернуть слот в число свободных (аналог Queue<size_t>::send)
+         * @param index Индекс слота
+         * @return true если индекс корректен
+         */
+        bool send(const size_t index, TickType_t = 0) const noexcept
+        {
+            if (!setFree(index)) return false;
+            if (mWaiters.load() > 0) xSemaphoreGive(mSlotFreed);
+            return true;
+        }
+
+        /**
+         * @brief Захватить свободный слот из обработчика прерывания (аналог Queue<size_t>::receiveFromISR)
+         * @param index Ссылка для сохранения индекса слота
+         * @return true если слот захвачен
+         */
+        bool receiveFromISR(size_t& index, BaseType_t&) const noexcept
+        {
+            return tryAcquire(index);
+        }
+
+        /**
+         * @brief Вернуть слот из обработчика прерывания (аналог Queue<size_t>::sendFromISR)
+         * @param index Индекс слота
+         * @return true если индекс корректен
+         */
+        bool sendFromISR(const size_t index, BaseType_t& higherPriorityTaskWoken) const noexcept
+        {
+            if (!setFree(index)) return false;
+            if (mWaiters.load() > 0) xSemaphoreGiveFromISR(mSlotFreed, &higherPriorityTaskWoken);
+            return true;
+        }
+
+        /// @brief Количество свободных слотов
+        [[nodiscard]] UBaseType_t messagesWaiting() const noexcept
+        {
+            UBaseType_t count = 0;
+            for (const auto& word : mWords)
+            {
+                count += static_cast<UBaseType_t>(__builtin_popcount(word.load(std::memory_order_relaxed)));
+            }
+            return count;
+        }
+
+    private:
+        static constexpr size_t WORD_BITS = 32;
+        static constexpr size_t WORDS = (Size + WORD_BITS - 1) / WORD_BITS;
+
+        /// @brief Маска допустимых слотов для слова карты
+        static constexpr uint32_t wordMask(const size_t word) noexcept
+        {
+            const size_t bits = Size - word * WORD_BITS;
+            return bits >= WORD_BITS ? UINT32_MAX : (1u << bits) - 1;
+        }
+
+        /// @brief Отметить слот свободным
+        bool setFree(const size_t index) const noexcept
+        {
+            if (index >= Size) return false;
+            mWords[index / WORD_BITS].fetch_or(1u << (index % WORD_BITS));
+            return true;
+        }
+
+        mutable std::array<std::atomic<uint32_t>, WORDS> mWords; ///< Биты свободных слотов
+        mutable std::atomic<UBaseType_t> mWaiters{0};            ///< Задачи, ожидающие свободного слота
+        StaticSemaphore_t mSlotFreedBuffer{};                    ///< Память семафора ожидания
+        SemaphoreHandle_t mSlotFreed = nullptr;                  ///< Сигнал возврата слота ожидающим задачам
+    };
+} // namespace esp32_c3::objects
+
+#endif // ESP32_C3_UTILS_SLOT_BITMAP_H
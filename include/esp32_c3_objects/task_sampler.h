@@ -0,0 +1,368 @@
+#ifndef ESP32_C3_UTILS_TASK_SAMPLER_H
+#define ESP32_C3_UTILS_TASK_SAMPLER_H
+
+#include "thread.h"
+#include "esp32_c3_utils/type_utils.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+
+namespace esp32_c3::objects
+{
+    /**
+     * @brief Периодический сбор загрузки CPU по задачам
+     * @tparam MaxTasks Максимальное количество задач в системе (включая системные)
+     * @tparam HistoryDepth Количество хранимых замеров
+     * @details Каждый замер вызывает uxTaskGetSystemState() и считает приращение счётчика
+     * времени выполнения каждой задачи с предыдущего замера. Доля CPU задачи - это приращение,
+     * делённое на приращение общего времени. Задачи сопоставляются между замерами по номеру
+     * (xTaskNumber), поэтому пересозданная задача с тем же именем не наследует чужой счётчик.
+     * Последние HistoryDepth замеров хранятся в кольцевом буфере.
+     * Замеры выполняет собственный поток (start()) или вызывающий код (sample()).
+     * Частота переключений контекста считается по всей системе: FreeRTOS не ведёт такого
+     * счётчика, поэтому его поставляет приложение через setSwitchCounter() (например, из
+     * макроса traceTASK_SWITCHED_IN). Без счётчика поля switches и switchesPerSecond равны 0.
+     * @note Требует CONFIG_FREERTOS_USE_TRACE_FACILITY и CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+     */
+    template <size_t MaxTasks, size_t HistoryDepth = 4>
+    class TaskSampler
+    {
+        static_assert(MaxTasks > 0, "TaskSampler must track at least one task");
+        static_assert(HistoryDepth > 0, "TaskSampler must keep at least one sample");
+
+    public:
+        /// @brief Размер стека по умолчанию
+        static constexpr uint32_t DEFAULT_STACK_DEPTH = 3072;
+
+        /// @brief Приоритет по умолчанию
+        static constexpr UBaseType_t DEFAULT_PRIORITY = 1;
+
+        /// @brief Период замеров по умолчанию в миллисекундах
+        static constexpr uint32_t DEFAULT_INTERVAL_MS = 1000;
+
+        /// @brief Полная загрузка в десятых долях процента
+        static constexpr uint16_t FULL_LOAD = 1000;
+
+        /**
+         * @brief Источник счётчика переключений контекста
+         * @details Возвращает монотонно растущее (с переполнением) число переключений с момента
+         * старта системы. Вызывается из потока замеров, поэтому должен быть потокобезопасным
+         */
+        using SwitchCounter = uint32_t (*)() noexcept;
+
+        /**
+         * @brief Загрузка одной задачи за интервал между замерами
+         */
+        struct TaskLoad
+        {
+            std::array<char, configMAX_TASK_NAME_LEN> name{}; ///< Имя задачи
+            TaskHandle_t handle = nullptr;                    ///< Дескриптор задачи
+            configRUN_TIME_COUNTER_TYPE runTime = 0;          ///< Время выполнения за интервал
+            uint32_t stackHighWaterMark = 0;                  ///< Минимальный запас стека
+            UBaseType_t priority = 0;                         ///< Текущий приоритет
+            uint16_t cpuPermille = 0;                         ///< Доля CPU (в десятых долях процента)
+            eTaskState state = eInvalid;                      ///< Состояние в момент замера
+        };
+
+        /**
+         * @brief Один замер
+         */
+        struct Snapshot
+        {
+            TickType_t timestamp = 0;                     ///< Время замера в тиках
+            configRUN_TIME_COUNTER_TYPE totalRunTime = 0; ///< Общее время за интервал
+            uint16_t busyPermille = 0;                    ///< Загрузка CPU без учёта idle-задачи
+            uint32_t switches = 0;                        ///< Переключений контекста за интервал
+            uint32_t switchesPerSecond = 0;               ///< Частота переключений контекста
+            size_t taskCount = 0;                         ///< Количество заполненных элементов tasks
+            std::array<TaskLoad, MaxTasks> tasks{};       ///< Загрузка по задачам
+        };
+
+        /**
+         * @brief Конструктор сборщика
+         * @param name Имя потока
+         * @param stackDepth Размер стека потока
+         * @param priority Приоритет потока
+         */
+        explicit TaskSampler(const std::string_view name,
+                             const uint32_t stackDepth = DEFAULT_STACK_DEPTH,
+                             const UBaseType_t priority = DEFAULT_PRIORITY) noexcept :
+            mThread(name, stackDepth, priority)
+        {
+            mLock = xSemaphoreCreateMutex();
+            if (!mLock)
+            {
+                ESP_LOGE((utils::generateTag<TaskSampler<MaxTasks, HistoryDepth>>()), "TaskSampler creation failed");
+            }
+        }
+
+        ~TaskSampler() noexcept
+        {
+            stop();
+            if (mLock) vSemaphoreDelete(mLock);
+        }
+
+        // Запрет копирования и перемещения (поток ссылается на объект)
+        TaskSampler(const TaskSampler&) = delete;
+        TaskSampler& operator=(const TaskSampler&) = delete;
+
+        /**
+         * @brief Проверка инициализации
+         * @return true если мьютекс создан
+         */
+        [[nodiscard]] bool isInitialized() const noexcept
+        {
+            return mLock != nullptr;
+        }
+
+        /**
+         * @brief Запуск периодических замеров
+         * @param intervalMs Период замеров в миллисекундах
+         * @return true если поток запущен
+         * @note Первый замер считает загрузку с момента старта системы
+         */
+        bool start(const uint32_t intervalMs = DEFAULT_INTERVAL_MS) noexcept
+        {
+            if (!isInitialized()) return false;
+
+            return mThread.start([this]
+            {
+                sample();
+                return Thread::LoopAction::CONTINUE;
+            }, intervalMs) == ESP_OK;
+        }
+
+        /// @brief Остановка периодических замеров (история сохраняется)
+        void stop() noexcept
+        {
+            mThread.stop();
+        }
+
+        /**
+         * @brief Установить источник счётчика переключений контекста
+         * @param counter Источник или nullptr для отключения
+         * @details Текущее значение счётчика и время вызова становятся базой для следующего
+         * замера, поэтому первый интервал не включает переключения до вызова
+         */
+        void setSwitchCounter(const SwitchCounter counter) noexcept
+        {
+            if (!isInitialized()) return;
+
+            xSemaphoreTake(mLock, portMAX_DELAY);
+            mSwitchCounter = counter;
+            mPrevSwitches = counter ? counter() : 0;
+            mPrevTimestamp = xTaskGetTickCount();
+            xSemaphoreGive(mLock);
+        }
+
+        /**
+         * @brief Выполнить замер
+         * @return true если замер добавлен в историю
+         */
+        bool sample() noexcept
+        {
+            if (!isInitialized()) return false;
+
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+            // Сбор выполняется под мьютексом: буфер состояний и счётчики общие для вызывающих
+            xSemaphoreTake(mLock, portMAX_DELAY);
+
+            configRUN_TIME_COUNTER_TYPE total = 0;
+            const UBaseType_t count = uxTaskGetSystemState(mStatus.data(), MaxTasks, &total);
+            if (count == 0)
+            {
+                xSemaphoreGive(mLock);
+                ESP_LOGW((utils::generateTag<TaskSampler<MaxTasks, HistoryDepth>>()),
+                         "More than %u tasks, sample skipped", static_cast<unsigned>(MaxTasks));
+                return false;
+            }
+
+            Snapshot& snapshot = mHistory[mHead];
+            snapshot.timestamp = xTaskGetTickCount();
+            snapshot.totalRunTime = total - mPrevTotal;
+            snapshot.taskCount = count;
+
+            const TaskHandle_t idle = xTaskGetIdleTaskHandle();
+            configRUN_TIME_COUNTER_TYPE idleRunTime = 0;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const TaskStatus_t& status = mStatus[i];
+                TaskLoad& load = snapshot.tasks[i];
+
+                std::strncpy(load.name.data(), status.pcTaskName, load.name.size() - 1);
+                load.name.back() = '\0';
+                load.handle = status.xHandle;
+                load.runTime = status.ulRunTimeCounter - previousRunTime(status.xTaskNumber);
+                load.stackHighWaterMark = status.usStackHighWaterMark;
+                load.priority = status.uxCurrentPriority;
+                load.cpuPermille = permille(load.runTime, snapshot.totalRunTime);
+                load.state = status.eCurrentState;
+
+                if (status.xHandle == idle) idleRunTime += load.runTime;
+            }
+            snapshot.busyPermille = FULL_LOAD - permille(idleRunTime, snapshot.totalRunTime);
+
+            // Частота по тикам между замерами: счётчик времени выполнения может идти в других единицах
+            const uint32_t switches = mSwitchCounter ? mSwitchCounter() : 0;
+            const TickType_t elapsed = snapshot.timestamp - mPrevTimestamp;
+            snapshot.switches = switches - mPrevSwitches;
+            snapshot.switchesPerSecond = elapsed == 0 ? 0 : static_cast<uint32_t>(
+                static_cast<uint64_t>(snapshot.switches) * configTICK_RATE_HZ / elapsed);
+
+            // Счётчики текущего замера становятся базой для следующего
+            for (size_t i = 0; i < count; ++i)
+            {
+                mPrev[i] = {mStatus[i].xTaskNumber, mStatus[i].ulRunTimeCounter};
+            }
+            mPrevCount = count;
+            mPrevTotal = total;
+            mPrevSwitches = switches;
+            mPrevTimestamp = snapshot.timestamp;
+
+            mHead = (mHead + 1) % HistoryDepth;
+            mCount = std::min(mCount + 1, HistoryDepth);
+
+            xSemaphoreGive(mLock);
+            return true;
+#else
+            ESP_LOGE((utils::generateTag<TaskSampler<MaxTasks, HistoryDepth>>()),
+                     "Run-time stats disabled (enable CONFIG_FREERTOS_USE_TRACE_FACILITY "
+                     "and CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS)");
+            return false;
+#endif
+        }
+
+        /// @brief Количество замеров в истории
+        [[nodiscard]] size_t samples() const noexcept
+        {
+            return mCount;
+        }
+
+        /**
+         * @brief Получить замер из истории
+         * @param[out] snapshot Копия замера
+         * @param age Возраст замера (0 - последний)
+         * @return true если замер с таким возрастом есть
+         */
+        bool history(Snapshot& snapshot, const size_t age = 0) const noexcept
+        {
+            if (!isInitialized()) return false;
+
+            xSemaphoreTake(mLock, portMAX_DELAY);
+            const Snapshot* found = at(age);
+            if (found) snapshot = *found;
+            xSemaphoreGive(mLock);
+
+            return found != nullptr;
+        }
+
+        /**
+         * @brief Найти загрузку задачи по имени
+         * @param name Имя задачи
+         * @param age Возраст замера (0 - последний)
+         * @return Загрузка задачи или std::nullopt, если задачи нет в замере
+         * @note Имя сравнивается с учётом усечения до configMAX_TASK_NAME_LEN - 1 символов
+         */
+        [[nodiscard]] std::optional<TaskLoad> find(const std::string_view name, const size_t age = 0) const noexcept
+        {
+            if (!isInitialized()) return std::nullopt;
+
+            const std::string_view key = name.substr(0, configMAX_TASK_NAME_LEN - 1);
+            std::optional<TaskLoad> result;
+
+            xSemaphoreTake(mLock, portMAX_DELAY);
+            if (const Snapshot* snapshot = at(age))
+            {
+                const auto begin = snapshot->tasks.begin();
+                const auto end = begin + snapshot->taskCount;
+                const auto it = std::find_if(begin, end, [key](const TaskLoad& load)
+                {
+                    return key == load.name.data();
+                });
+                if (it != end) result = *it;
+            }
+            xSemaphoreGive(mLock);
+
+            return result;
+        }
+
+        /**
+         * @brief Найти загрузку потока
+         * @param thread Поток (сопоставляется по name())
+         * @param age Возраст замера (0 - последний)
+         * @return Загрузка потока или std::nullopt, если поток не запущен в момент замера
+         */
+        [[nodiscard]] std::optional<TaskLoad> find(const Thread& thread, const size_t age = 0) const noexcept
+        {
+            return find(thread.name(), age);
+        }
+
+        /// @brief Поток сборщика
+        [[nodiscard]] Thread& thread() noexcept
+        {
+            return mThread;
+        }
+
+    private:
+        /**
+         * @brief Счётчик задачи на предыдущем замере
+         */
+        struct Counter
+        {
+            UBaseType_t number = 0;                  ///< Номер задачи (xTaskNumber)
+            configRUN_TIME_COUNTER_TYPE runTime = 0; ///< Счётчик времени выполнения
+        };
+
+        /// @brief Доля в десятых долях процента
+        static uint16_t permille(const configRUN_TIME_COUNTER_TYPE part,
+                                 const configRUN_TIME_COUNTER_TYPE total) noexcept
+        {
+            if (total == 0) return 0;
+            const uint64_t value = static_cast<uint64_t>(part) * FULL_LOAD / total;
+            return static_cast<uint16_t>(std::min<uint64_t>(value, FULL_LOAD));
+        }
+
+        /// @brief Счётчик задачи на предыдущем замере (0 для новой задачи)
+        [[nodiscard]] configRUN_TIME_COUNTER_TYPE previousRunTime(const UBaseType_t number) const noexcept
+        {
+            const auto end = mPrev.begin() + mPrevCount;
+            const auto it = std::find_if(mPrev.begin(), end, [number](const Counter& counter)
+            {
+                return counter.number == number;
+            });
+            return it != end ? it->runTime : 0;
+        }
+
+        /// @brief Замер по возрасту (вызывается под мьютексом)
+        [[nodiscard]] const Snapshot* at(const size_t age) const noexcept
+        {
+            if (age >= mCount) return nullptr;
+            return &mHistory[(mHead + HistoryDepth - 1 - age) % HistoryDepth];
+        }
+
+        Thread mThread;                                ///< Поток замеров
+        SemaphoreHandle_t mLock = nullptr;             ///< Защита истории и счётчиков
+        std::array<TaskStatus_t, MaxTasks> mStatus{};  ///< Буфер uxTaskGetSystemState
+        std::array<Counter, MaxTasks> mPrev{};         ///< Счётчики предыдущего замера
+        size_t mPrevCount = 0;                         ///< Количество задач в mPrev
+        configRUN_TIME_COUNTER_TYPE mPrevTotal = 0;    ///< Общее время предыдущего замера
+        SwitchCounter mSwitchCounter = nullptr;        ///< Источник счётчика переключений
+        uint32_t mPrevSwitches = 0;                    ///< Счётчик переключений предыдущего замера
+        TickType_t mPrevTimestamp = 0;                 ///< Время предыдущего замера в тиках
+        std::array<Snapshot, HistoryDepth> mHistory{}; ///< Кольцевой буфер замеров
+        size_t mHead = 0;                              ///< Индекс следующей записи
+        size_t mCount = 0;                             ///< Количество замеров в истории
+    };
+} // namespace esp32_c3::objects
+
+#endif // ESP32_C3_UTILS_TASK_SAMPLER_H
@@ -5,11 +5,15 @@
 #include <atomic>
 #include <cstdint>
 #include <functional>
-#include <memory>
+#include <optional>
 #include <string_view>
 
 #include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <freertos/task.h>
+#include <esp_timer.h>
+
+#include "esp32_c3_utils/inplace_function.h"
 
 namespace esp32_c3::objects
 {
@@ -18,11 +22,33 @@ namespace esp32_c3::objects
      */
     constexpr size_t THREAD_NAME_SIZE = 32;
 
+    /**
+     * @brief Индекс уведомления, которым Thread будит задачу цикла (остановка и таймер периода)
+     * @details Отдельный индекс не смешивается с уведомлениями, которые использует функция цикла.
+     * При CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES = 1 используется общий индекс 0
+     */
+    constexpr UBaseType_t THREAD_NOTIFY_INDEX = configTASK_NOTIFICATION_ARRAY_ENTRIES > 1 ? 1 : 0;
+
+    /**
+     * @brief Статическое хранилище задачи FreeRTOS (стек и TCB)
+     * @tparam StackDepth Размер стека в единицах StackType_t (как stackDepth в конструкторе Thread)
+     * @details Объявленное как глобальный или статический объект, размещается в .bss,
+     * и задача создаётся без обращения к куче (xTaskCreateStatic)
+     * @note Функция задачи, запущенной через start(TaskFunction_t, ...), не должна удалять себя
+     * через vTaskDelete(nullptr): до очистки idle-задачей TCB нельзя использовать повторно
+     */
+    template <uint32_t StackDepth>
+    struct ThreadStorage
+    {
+        StaticTask_t tcb;                          ///< Управляющий блок задачи
+        std::array<StackType_t, StackDepth> stack; ///< Стек задачи
+    };
+
     /**
      * @brief Класс-обертка для работы с задачами FreeRTOS
      * @details Предоставляет удобный интерфейс для создания и управления задачами,
      * включая контроль стека, приоритетов и привязку к ядрам процессора.
-     * Поддерживает ESP-IDF v5+ и использует возможности C++17.
+     * Поддерживает ESP-IDF v5+ и использует возможности C++23 (проект собирается с -std=gnu++2b).
      */
     class Thread
     {
@@ -35,6 +61,27 @@ namespace esp32_c3::objects
             STOP      ///< Остановить поток
         };
 
+        /// @brief Режимы ожидания между итерациями цикла
+        enum class LoopMode
+        {
+            INTERVAL,     ///< Пауза на заданный интервал после каждой итерации
+            EVENT_DRIVEN, ///< Без паузы: тело цикла само блокируется на своём источнике событий
+            PERIODIC      ///< Фиксированный период без накопления дрейфа (отсчёт тиков или esp_timer)
+        };
+
+        /**
+         * @brief Статистика периодического режима
+         * @details Джиттер - отклонение фактического интервала между пробуждениями от заданного периода.
+         * Итерации с переполнением в расчёт джиттера не входят
+         */
+        struct PeriodStats
+        {
+            uint32_t iterations = 0;  ///< Количество пробуждений
+            uint32_t overruns = 0;    ///< Пробуждения после пропущенного периода (тело цикла не уложилось)
+            uint32_t maxJitterUs = 0; ///< Максимальный джиттер, мкс
+            uint32_t avgJitterUs = 0; ///< Средний джиттер, мкс
+        };
+
         /// @brief Состояния потока
         enum class State
         {
@@ -47,8 +94,29 @@ namespace esp32_c3::objects
         /// @brief Тег для логирования
         static constexpr auto TAG = "Thread";
 
-        /// @brief Тип функции цикла выполнения
+        /// @brief Минимальный период esp_timer в периодическом режиме, мкс
+        static constexpr uint32_t MIN_TIMER_PERIOD_US = 50;
+
+        /// @brief Время ожидания мягкой остановки до принудительного удаления задачи, мс
+        static constexpr uint32_t STOP_TIMEOUT_MS = 1000;
+
+        /**
+         * @brief Тип функции цикла выполнения
+         * @details При заданном макросе THREAD_LOOP_FUNC_CAPACITY (например, -D THREAD_LOOP_FUNC_CAPACITY=16)
+         * используется utils::InplaceFunction указанной ёмкости без обращения к куче
+         */
+#ifdef THREAD_LOOP_FUNC_CAPACITY
+        using LoopFunc = utils::InplaceFunction<LoopAction(), THREAD_LOOP_FUNC_CAPACITY>;
+#else
         using LoopFunc = std::function<LoopAction()>;
+#endif
+
+        /// @brief Тип функции пробуждения цикла, заблокированного на собственном источнике событий
+#ifdef THREAD_LOOP_FUNC_CAPACITY
+        using WakeFunc = utils::InplaceFunction<void(), THREAD_LOOP_FUNC_CAPACITY>;
+#else
+        using WakeFunc = std::function<void()>;
+#endif
 
         /**
          * @brief Конструктор задачи FreeRTOS
@@ -58,6 +126,21 @@ namespace esp32_c3::objects
          */
         explicit Thread(std::string_view name, uint32_t stackDepth, UBaseType_t priority) noexcept;
 
+        /**
+         * @brief Конструктор задачи FreeRTOS на статическом хранилище (без выделения памяти в куче)
+         * @tparam StackDepth Размер стека
+         * @param name Имя задачи (максимум 31 символ + нуль-терминатор)
+         * @param storage Хранилище стека и TCB (должно существовать дольше объекта Thread)
+         * @param priority Приоритет задачи (0 - самый низкий)
+         */
+        template <uint32_t StackDepth>
+        Thread(const std::string_view name, ThreadStorage<StackDepth>& storage, const UBaseType_t priority) noexcept :
+            Thread(name, StackDepth, priority)
+        {
+            mStaticStack = storage.stack.data();
+            mStaticTcb = &storage.tcb;
+        }
+
         /// @brief Деструктор - автоматически останавливает задачу
         ~Thread() noexcept;
 
@@ -76,6 +159,32 @@ namespace esp32_c3::objects
          */
         [[nodiscard]] esp_err_t start(LoopFunc loopFunc, uint32_t intervalMs = 10, bool startPaused = false) noexcept;
 
+        /**
+         * @brief Запуск задачи с событийным циклом выполнения
+         * @param loopFunc Функция цикла выполнения (должна блокироваться на очереди, уведомлении и т.п.)
+         * @param startPaused Запустить в приостановленном состоянии
+         * @return Код ошибки ESP_OK в случае успеха
+         * @note После LoopAction::CONTINUE цикл сразу возвращается к ожиданию без vTaskDelay,
+         * поэтому функция, которая не блокируется, не даст выполняться задачам с меньшим приоритетом.
+         * Чтобы stop() не ждал таймаута, источник событий должен будить функцию при остановке
+         * (см. setWakeHook())
+         */
+        [[nodiscard]] esp_err_t startEventDriven(LoopFunc loopFunc, bool startPaused = false) noexcept;
+
+        /**
+         * @brief Запуск задачи с периодическим циклом выполнения
+         * @param loopFunc Функция цикла выполнения
+         * @param periodUs Период в микросекундах (больше нуля)
+         * @param startPaused Запустить в приостановленном состоянии
+         * @return Код ошибки ESP_OK в случае успеха
+         * @details Период, кратный тику, отсчитывается от предыдущего пробуждения (как vTaskDelayUntil),
+         * поэтому время выполнения тела цикла не сдвигает расписание. Остальные периоды
+         * (от MIN_TIMER_PERIOD_US) задаёт периодический esp_timer, будящий задачу уведомлением.
+         * Пропущенные периоды не догоняются серией итераций, а учитываются в periodStats()
+         * @note Функция цикла не должна использовать уведомление с индексом THREAD_NOTIFY_INDEX
+         */
+        [[nodiscard]] esp_err_t startPeriodic(LoopFunc loopFunc, uint32_t periodUs, bool startPaused = false) noexcept;
+
         /**
          * @brief Запуск задачи на любом доступном ядре
          * @param taskFunc Функция-задача (бесконечный цикл)
@@ -96,14 +205,32 @@ namespace esp32_c3::objects
         /**
          * @brief Запуск/проверка рабочего потока
          * @param loopFunc Функция цикла выполнения
+         * @param mode Режим ожидания между итерациями
          * @return true если поток успешно запущен или уже работает
          */
-        bool quickStart(const LoopFunc& loopFunc);
+        bool quickStart(const LoopFunc& loopFunc, LoopMode mode = LoopMode::INTERVAL);
+
+        /**
+         * @brief Установка функции пробуждения цикла для stop()
+         * @param hook Функция, прерывающая ожидание функции цикла на её источнике событий
+         * (например, отправка служебного элемента в очередь или уведомления)
+         * @details Свои ожидания (интервал и период) Thread прерывает уведомлением с индексом
+         * THREAD_NOTIFY_INDEX. Функция цикла в событийном режиме блокируется на чужом источнике,
+         * поэтому stop() вызывает эту функцию до завершения цикла (повторно каждый тик)
+         * @note Устанавливается до запуска; функция вызывается из задачи, вызвавшей stop()
+         */
+        void setWakeHook(WakeFunc hook) noexcept;
 
         /**
          * @brief Остановка и удаление задачи
          * @param softStop Флаг мягкой остановки (true - ожидание завершения, false - принудительная)
-         * @note Безопасно вызывать даже если задача не запущена
+         * @details Мягкая остановка выставляет флаг остановки, будит задачу цикла и ждёт сигнала
+         * о её завершении (не дольше STOP_TIMEOUT_MS, затем задача удаляется принудительно).
+         * Задача пробуждается уведомлением с индексом THREAD_NOTIFY_INDEX и функцией setWakeHook(),
+         * приостановленная - возобновляется. Чужие блокирующие вызовы внутри функции цикла не прерываются.
+         * После возврата задача цикла завершена, а её контекст (функция цикла с захваченным состоянием) уничтожен.
+         * @note Безопасно вызывать даже если задача не запущена. Вызов из самой задачи цикла только
+         * запрашивает остановку: цикл завершится после возврата из текущей итерации
          */
         void stop(bool softStop = true) noexcept;
 
@@ -113,6 +240,12 @@ namespace esp32_c3::objects
          */
         [[nodiscard]] State state() const noexcept;
 
+        /**
+         * @brief Проверка, что вызов выполняется в самом потоке
+         * @return true если текущая задача - задача этого потока
+         */
+        [[nodiscard]] bool isCurrent() const noexcept;
+
         /**
          * @brief Приостановка выполнения задачи
          * @note Задачу можно возобновить методом resume()
@@ -160,6 +293,13 @@ namespace esp32_c3::objects
          */
         [[nodiscard]] const char* name() const noexcept;
 
+        /**
+         * @brief Получение статистики периодического режима
+         * @param reset Обнулить статистику после чтения
+         * @return Статистика с момента запуска или последнего сброса
+         */
+        [[nodiscard]] PeriodStats periodStats(bool reset = false) noexcept;
+
     private:
         /**
          * @brief Контекст для цикла выполнения
@@ -168,14 +308,24 @@ namespace esp32_c3::objects
         {
             LoopFunc func;                   ///< Функция цикла
             TickType_t interval;             ///< Интервал выполнения
+            LoopMode mode;                   ///< Режим ожидания между итерациями
             Thread* thread;                  ///< Указатель на родительский объект
             std::atomic<bool> shouldStop;    ///< Флаг остановки
             std::atomic<bool> isStartPaused; ///< Флаг старта в приостановленном состоянии
 
+            // Периодический режим
+            uint32_t periodUs = 0;                          ///< Период в микросекундах
+            std::atomic<esp_timer_handle_t> timer{nullptr}; ///< Таймер периода (nullptr - отсчёт тиков)
+            TaskHandle_t task = nullptr;                    ///< Задача, которую будит таймер
+            TickType_t lastWake = 0;                        ///< Тик последнего пробуждения
+            int64_t lastWakeUs = 0;                         ///< Время последнего пробуждения, мкс
+
             // Явно объявляем конструктор
-            LoopContext(LoopFunc&& f, const TickType_t i, Thread* t, const bool stop, const bool paused) :
+            LoopContext(LoopFunc&& f, const TickType_t i, const LoopMode m, Thread* t, const bool stop,
+                        const bool paused) :
                 func(std::move(f)),
                 interval(i),
+                mode(m),
                 thread(t),
                 shouldStop(stop),
                 isStartPaused(paused)
@@ -183,12 +333,78 @@ namespace esp32_c3::objects
             }
         };
 
+        /**
+         * @brief Создание задачи с циклом выполнения
+         * @param loopFunc Функция цикла выполнения
+         * @param interval Интервал выполнения в тиках
+         * @param mode Режим ожидания между итерациями
+         * @param startPaused Запустить в приостановленном состоянии
+         * @return Код ошибки ESP_OK в случае успеха
+         */
+        [[nodiscard]] esp_err_t startLoop(LoopFunc&& loopFunc, TickType_t interval, LoopMode mode,
+                                          bool startPaused, uint32_t periodUs = 0) noexcept;
+
+        /**
+         * @brief Создание задачи FreeRTOS (в куче или на статическом хранилище)
+         * @param taskFunc Функция-задача
+         * @param params Параметры для передачи в задачу
+         * @param coreId Номер ядра или tskNO_AFFINITY
+         * @param handle Ссылка для сохранения хэндла задачи
+         * @return true если задача создана
+         */
+        [[nodiscard]] bool createTask(TaskFunction_t taskFunc, void* params, BaseType_t coreId,
+                                      TaskHandle_t& handle) noexcept;
+
         /**
          * @brief Обертка для функции цикла выполнения
          * @param arg Указатель на контекст LoopContext
          */
         static void loopWrapper(void* arg) noexcept;
 
+        /**
+         * @brief Дождаться завершения задачи цикла
+         * @param handle Хэндл задачи цикла
+         * @param timeout Максимальное время ожидания
+         * @return true если задача завершила цикл
+         */
+        [[nodiscard]] bool join(TaskHandle_t handle, TickType_t timeout) noexcept;
+
+        /**
+         * @brief Разбудить задачу цикла, чтобы она проверила флаг остановки
+         * @param handle Хэндл задачи цикла
+         */
+        void wake(TaskHandle_t handle) const noexcept;
+
+        /**
+         * @brief Начать отсчёт периода заново (после старта или приостановки)
+         * @param ctx Контекст цикла
+         */
+        static void restartPeriod(LoopContext& ctx) noexcept;
+
+        /**
+         * @brief Ожидание следующего периода и учёт статистики
+         * @param ctx Контекст цикла
+         */
+        static void waitPeriod(LoopContext& ctx) noexcept;
+
+        /**
+         * @brief Обработчик esp_timer: будит задачу периодического цикла
+         * @param arg Указатель на контекст LoopContext
+         */
+        static void onPeriodTimer(void* arg) noexcept;
+
+        /**
+         * @brief Остановить и удалить таймер периода, если он есть
+         * @param ctx Контекст цикла
+         */
+        static void releasePeriodTimer(LoopContext& ctx) noexcept;
+
+        /**
+         * @brief Уничтожить контекст завершённого цикла (вместе с таймером периода)
+         * @note Вызывается только когда задача цикла не выполняется
+         */
+        void resetLoopContext() noexcept;
+
         // Примитивные типы
         uint32_t mStackDepth;  ///< Запрошенный размер стека
         UBaseType_t mPriority; ///< Приоритет задачи
@@ -197,10 +413,26 @@ namespace esp32_c3::objects
         std::array<char, THREAD_NAME_SIZE> mName; ///< Имя задачи (для отладки)
 
         // Указатели
-        std::atomic<TaskHandle_t> mHandle{nullptr}; ///< Хэндл задачи FreeRTOS
-        std::unique_ptr<LoopContext> mLoopContext;  ///< Контекст цикла выполнения
+        std::atomic<TaskHandle_t> mHandle{nullptr};       ///< Хэндл задачи FreeRTOS
+        std::atomic<TaskHandle_t> mParkedHandle{nullptr}; ///< Завершившая цикл статическая задача
+        StackType_t* mStaticStack = nullptr;              ///< Статический стек (nullptr - стек в куче)
+        StaticTask_t* mStaticTcb = nullptr;               ///< Статический TCB
+
+        // Контейнеры
+        std::optional<LoopContext> mLoopContext; ///< Контекст цикла выполнения
+        WakeFunc mWakeHook;                      ///< Пробуждение функции цикла при остановке
+
+        // Синхронизация
+        StaticSemaphore_t mExitedBuffer{};  ///< Память семафора завершения
+        SemaphoreHandle_t mExited = nullptr; ///< Сигнал завершения цикла (выдаёт задача цикла)
 
         const UBaseType_t mStackWarningThreshold; ///< Порог для предупреждений
+
+        // Статистика периодического режима (пишет только задача цикла)
+        std::atomic<uint32_t> mPeriodIterations{0}; ///< Количество пробуждений
+        std::atomic<uint32_t> mPeriodOverruns{0};   ///< Пропуски периода
+        std::atomic<uint32_t> mMaxJitterUs{0};      ///< Максимальный джиттер
+        std::atomic<uint64_t> mJitterSumUs{0};      ///< Суммарный джиттер
     };
 } // namespace esp32_c3::objects
 
@@ -11,6 +11,7 @@
 #include "esp32_c3_utils/clock_utils.h"
 #include "esp32_c3_utils/core_dump.h"
 #include "esp32_c3_utils/crypto_utils.h"
+#include "esp32_c3_utils/inplace_function.h"
 #include "esp32_c3_utils/power_utils.h"
 #include "esp32_c3_utils/rtc_utils.h"
 #include "esp32_c3_utils/sleep_utils.h"
@@ -21,8 +22,18 @@
 /// Объекты
 #include "esp32_c3_objects/buffered_queue.h"
 #include "esp32_c3_objects/callback.h"
+#include "esp32_c3_objects/completion.h"
+#include "esp32_c3_objects/coroutine.h"
+#include "esp32_c3_objects/executor.h"
+#include "esp32_c3_objects/handler_stats.h"
 #include "esp32_c3_objects/led.h"
+#include "esp32_c3_objects/message_queue.h"
 #include "esp32_c3_objects/queue.h"
+#include "esp32_c3_objects/queue_set.h"
+#include "esp32_c3_objects/queue_stats.h"
+#include "esp32_c3_objects/scheduler.h"
+#include "esp32_c3_objects/slot_bitmap.h"
+#include "esp32_c3_objects/task_sampler.h"
 #include "esp32_c3_objects/temp_sensor.h"
 #include "esp32_c3_objects/thread.h"
 
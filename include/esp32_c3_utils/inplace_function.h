@@ -0,0 +1,168 @@
+#ifndef ESP32_C3_INPLACE_FUNCTION_H
+#define ESP32_C3_INPLACE_FUNCTION_H
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace esp32_c3::utils
+{
+    /// @brief Ёмкость InplaceFunction по умолчанию (в байтах)
+    constexpr size_t INPLACE_FUNCTION_DEFAULT_CAPACITY = 4 * sizeof(void*);
+
+    template <typename Signature, size_t Capacity = INPLACE_FUNCTION_DEFAULT_CAPACITY>
+    class InplaceFunction;
+
+    /**
+     * @brief Замена std::function с хранением захваченного состояния внутри объекта
+     * @tparam R Тип возвращаемого значения
+     * @tparam Args Типы аргументов
+     * @tparam Capacity Размер встроенного буфера под вызываемый объект (в байтах)
+     * @details Никогда не обращается к куче: вызываемый объект, не помещающийся в Capacity,
+     * вызывает ошибку компиляции. Размер и стоимость копирования объекта детерминированы.
+     * @note Вызов пустого объекта - неопределённое поведение (исключения не используются)
+     */
+    template <typename R, typename... Args, size_t Capacity>
+    class InplaceFunction<R(Args...), Capacity>
+    {
+        static_assert(Capacity >= sizeof(void*), "InplaceFunction capacity must hold at least a pointer");
+
+    public:
+        InplaceFunction() noexcept = default;
+
+        InplaceFunction(std::nullptr_t) noexcept // NOLINT(google-explicit-constructor)
+        {
+        }
+
+        /**
+         * @brief Конструктор из вызываемого объекта
+         * @param func Лямбда, указатель на функцию или функциональный объект
+         */
+        template <typename F,
+                  typename Fn = std::decay_t<F>,
+                  typename = std::enable_if_t<!std::is_same_v<Fn, InplaceFunction> &&
+                                              std::is_invocable_r_v<R, Fn&, Args...>>>
+        InplaceFunction(F&& func) noexcept(std::is_nothrow_constructible_v<Fn, F>) // NOLINT(google-explicit-constructor)
+        {
+            static_assert(sizeof(Fn) <= Capacity, "Callable does not fit into InplaceFunction capacity");
+            static_assert(alignof(Fn) <= alignof(std::max_align_t), "Callable alignment is not supported");
+            static_assert(std::is_copy_constructible_v<Fn>, "Callable must be copy constructible");
+
+            if constexpr (std::is_pointer_v<Fn> || std::is_member_pointer_v<Fn>)
+            {
+                if (func == nullptr) return;
+            }
+
+            ::new (static_cast<void*>(mStorage)) Fn(std::forward<F>(func));
+            mOps = &OPS<Fn>;
+        }
+
+        InplaceFunction(const InplaceFunction& other)
+        {
+            if (other.mOps)
+            {
+                other.mOps->copy(mStorage, other.mStorage);
+                mOps = other.mOps;
+            }
+        }
+
+        InplaceFunction(InplaceFunction&& other) noexcept
+        {
+            if (other.mOps)
+            {
+                other.mOps->move(mStorage, other.mStorage);
+                mOps = other.mOps;
+                other.reset();
+            }
+        }
+
+        InplaceFunction& operator=(const InplaceFunction& other)
+        {
+            if (this != &other)
+            {
+                reset();
+                if (other.mOps)
+                {
+                    other.mOps->copy(mStorage, other.mStorage);
+                    mOps = other.mOps;
+                }
+            }
+            return *this;
+        }
+
+        InplaceFunction& operator=(InplaceFunction&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                if (other.mOps)
+                {
+                    other.mOps->move(mStorage, other.mStorage);
+                    mOps = other.mOps;
+                    other.reset();
+                }
+            }
+            return *this;
+        }
+
+        InplaceFunction& operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        ~InplaceFunction() noexcept
+        {
+            reset();
+        }
+
+        /// @brief Проверка наличия вызываемого объекта
+        explicit operator bool() const noexcept
+        {
+            return mOps != nullptr;
+        }
+
+        /// @brief Вызов сохранённого объекта
+        R operator()(Args... args) const
+        {
+            return mOps->invoke(mStorage, std::forward<Args>(args)...);
+        }
+
+    private:
+        /// @brief Таблица операций над хранимым типом
+        struct Ops
+        {
+            R (*invoke)(void*, Args&&...);
+            void (*copy)(void*, const void*);
+            void (*move)(void*, void*);
+            void (*destroy)(void*) noexcept;
+        };
+
+        template <typename Fn>
+        static constexpr Ops OPS = {
+            [](void* self, Args&&... args) -> R
+            {
+                return std::invoke(*static_cast<Fn*>(self), std::forward<Args>(args)...);
+            },
+            [](void* dst, const void* src) { ::new (dst) Fn(*static_cast<const Fn*>(src)); },
+            [](void* dst, void* src) { ::new (dst) Fn(std::move(*static_cast<Fn*>(src))); },
+            [](void* self) noexcept { static_cast<Fn*>(self)->~Fn(); },
+        };
+
+        void reset() noexcept
+        {
+            if (mOps)
+            {
+                mOps->destroy(mStorage);
+                mOps = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) mutable std::byte mStorage[Capacity]; ///< Буфер вызываемого объекта
+        const Ops* mOps = nullptr;                                      ///< Операции над хранимым типом
+    };
+} // namespace esp32_c3::utils
+
+#endif // ESP32_C3_INPLACE_FUNCTION_H
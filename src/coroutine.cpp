@@ -0,0 +1,311 @@
+#include "esp32_c3_objects/coroutine.h"
+
+#include <algorithm>
+#include <cstring>
+#include <esp_log.h>
+
+namespace esp32_c3::objects
+{
+    namespace
+    {
+        /// @brief Сравнение сроков с учётом переполнения счётчика тиков
+        bool earlier(const TickType_t a, const TickType_t b) noexcept
+        {
+            return static_cast<int32_t>(a - b) < 0;
+        }
+    } // namespace
+
+    CoroutineRuntime::~CoroutineRuntime() noexcept
+    {
+        stop();
+        for (size_t i = 0; i < mSlots.size(); ++i)
+        {
+            Slot& slot = mSlots[i];
+            const Slot::State state = slot.state.load();
+            if (state == Slot::State::WAITING)
+            {
+                const Wait wait = slot.wait;
+                destroy(slot);
+                releaseSource(wait);
+            }
+            else if (state == Slot::State::ALLOCATED)
+            {
+                // Кадр ещё принадлежит объекту Coroutine: после уничтожения исполнителя
+                // operator delete обратился бы к несуществующему пулу
+                const auto handle = std::coroutine_handle<Coroutine::promise_type>::from_address(
+                    mFrames + i * mFrameStride + FRAME_HEADER);
+                if (Coroutine* owner = handle.promise().owner)
+                {
+                    owner->mHandle = nullptr;
+                }
+                handle.destroy();
+            }
+        }
+    }
+
+    bool CoroutineRuntime::start() noexcept
+    {
+        return mThread.quickStart([this] { return runOnce(); }, Thread::LoopMode::EVENT_DRIVEN);
+    }
+
+    void CoroutineRuntime::stop() noexcept
+    {
+        mThread.stop();
+    }
+
+    CoroutineRuntime::FlowId CoroutineRuntime::spawn(Coroutine&& flow) noexcept
+    {
+        if (!flow) return INVALID_FLOW;
+
+        const FlowId id = slotOf(flow.mHandle.address());
+        if (id == INVALID_FLOW || mSlots[id].state.load() != Slot::State::ALLOCATED)
+        {
+            ESP_LOGE(TAG, "Coroutine frame does not belong to this runtime");
+            return INVALID_FLOW;
+        }
+
+        const auto handle = std::exchange(flow.mHandle, nullptr);
+        handle.promise().owner = nullptr;
+
+        Slot& slot = mSlots[id];
+        slot.handle = handle;
+        slot.wait = {nullptr, nullptr, xTaskGetTickCount(), true, false};
+        slot.cancelRequested.store(false);
+        slot.state.store(Slot::State::WAITING, std::memory_order_release);
+
+        wake();
+        return id;
+    }
+
+    bool CoroutineRuntime::cancel(const FlowId id) noexcept
+    {
+        if (id < 0 || static_cast<size_t>(id) >= mSlots.size()) return false;
+
+        const Slot::State state = mSlots[id].state.load();
+        if (state != Slot::State::WAITING && state != Slot::State::RUNNING) return false;
+
+        mSlots[id].cancelRequested.store(true);
+        wake();
+        return true;
+    }
+
+    bool CoroutineRuntime::isAlive(const FlowId id) const noexcept
+    {
+        if (id < 0 || static_cast<size_t>(id) >= mSlots.size()) return false;
+
+        const Slot::State state = mSlots[id].state.load();
+        return state == Slot::State::WAITING || state == Slot::State::RUNNING;
+    }
+
+    size_t CoroutineRuntime::activeFlows() const noexcept
+    {
+        return std::count_if(mSlots.begin(), mSlots.end(), [](const Slot& slot)
+        {
+            const Slot::State state = slot.state.load(std::memory_order_relaxed);
+            return state == Slot::State::WAITING || state == Slot::State::RUNNING;
+        });
+    }
+
+    void CoroutineRuntime::notify(const uint32_t bits) noexcept
+    {
+        mBits.fetch_or(bits);
+        wake();
+    }
+
+    void CoroutineRuntime::notifyFromISR(const uint32_t bits, BaseType_t& higherPriorityTaskWoken) noexcept
+    {
+        mBits.fetch_or(bits);
+        if (const TaskHandle_t task = mTask.load())
+        {
+            vTaskNotifyGiveFromISR(task, &higherPriorityTaskWoken);
+        }
+    }
+
+    void CoroutineRuntime::wake() noexcept
+    {
+        // Вызов из самой сопрограммы тоже уведомляет поток: сопрограмма, проверенная раньше
+        // в этом проходе, иначе не увидела бы событие до следующего пробуждения
+        if (const TaskHandle_t task = mTask.load())
+        {
+            xTaskNotifyGive(task);
+        }
+    }
+
+    void CoroutineRuntime::onQueueSend(void* context) noexcept
+    {
+        static_cast<CoroutineRuntime*>(context)->wake();
+    }
+
+    void CoroutineRuntime::onQueueSendFromISR(void* context, BaseType_t& higherPriorityTaskWoken) noexcept
+    {
+        if (const TaskHandle_t task = static_cast<CoroutineRuntime*>(context)->mTask.load())
+        {
+            vTaskNotifyGiveFromISR(task, &higherPriorityTaskWoken);
+        }
+    }
+
+    void CoroutineRuntime::releaseSource(const Wait& wait) const noexcept
+    {
+        if (!wait.source) return;
+
+        // Ожидания изменяются только потоком исполнителя, поэтому проверка не требует блокировок
+        for (const Slot& slot : mSlots)
+        {
+            if (slot.state.load(std::memory_order_relaxed) == Slot::State::WAITING &&
+                slot.wait.source == wait.source)
+            {
+                return;
+            }
+        }
+        wait.detach(wait.source, mSendHook);
+    }
+
+    void* CoroutineRuntime::allocateFrame(const size_t size) noexcept
+    {
+        if (size > mFrameSize)
+        {
+            ESP_LOGE(TAG, "Coroutine frame of %u bytes exceeds pool frame size %u", static_cast<unsigned>(size),
+                     static_cast<unsigned>(mFrameSize));
+            return nullptr;
+        }
+
+        for (size_t i = 0; i < mSlots.size(); ++i)
+        {
+            Slot::State expected = Slot::State::FREE;
+            if (mSlots[i].state.compare_exchange_strong(expected, Slot::State::ALLOCATED))
+            {
+                // Заголовок позволяет operator delete найти исполнитель по адресу кадра
+                std::byte* block = mFrames + i * mFrameStride;
+                CoroutineRuntime* self = this;
+                std::memcpy(block, &self, sizeof(self));
+                return block + FRAME_HEADER;
+            }
+        }
+
+        ESP_LOGE(TAG, "Coroutine pool exhausted (%u frames)", static_cast<unsigned>(mSlots.size()));
+        return nullptr;
+    }
+
+    void CoroutineRuntime::freeFrame(void* frame) noexcept
+    {
+        const std::byte* block = static_cast<std::byte*>(frame) - FRAME_HEADER;
+        CoroutineRuntime* runtime;
+        std::memcpy(&runtime, block, sizeof(runtime));
+
+        Slot& slot = runtime->mSlots[runtime->slotOf(frame)];
+        slot.handle = nullptr;
+        slot.cancelRequested.store(false);
+        slot.state.store(Slot::State::FREE, std::memory_order_release);
+    }
+
+    CoroutineRuntime::FlowId CoroutineRuntime::slotOf(const void* frame) const noexcept
+    {
+        // Адреса сравниваются как целые: кадр другого пула не связан с mFrames
+        const auto address = reinterpret_cast<uintptr_t>(frame);
+        const auto begin = reinterpret_cast<uintptr_t>(mFrames) + FRAME_HEADER;
+        if (address < begin) return INVALID_FLOW;
+
+        const uintptr_t offset = address - begin;
+        if (offset % mFrameStride != 0 || offset / mFrameStride >= mSlots.size()) return INVALID_FLOW;
+
+        return static_cast<FlowId>(offset / mFrameStride);
+    }
+
+    void CoroutineRuntime::park(Wait wait, const TickType_t ticks) noexcept
+    {
+        if (wait.hasDeadline)
+        {
+            wait.deadline = xTaskGetTickCount() + ticks;
+        }
+        mSlots[mCurrent].wait = wait;
+    }
+
+    uint32_t CoroutineRuntime::takeBits(const uint32_t mask) noexcept
+    {
+        return mBits.fetch_and(~mask) & mask;
+    }
+
+    void CoroutineRuntime::destroy(Slot& slot) noexcept
+    {
+        slot.state.store(Slot::State::RUNNING);
+        // Уничтожение кадра возвращает слот в пул (operator delete)
+        slot.handle.destroy();
+    }
+
+    Thread::LoopAction CoroutineRuntime::runOnce() noexcept
+    {
+        mTask.store(xTaskGetCurrentTaskHandle());
+
+        TickType_t sleep = portMAX_DELAY;
+        for (size_t i = 0; i < mSlots.size(); ++i)
+        {
+            Slot& slot = mSlots[i];
+            if (slot.state.load(std::memory_order_acquire) != Slot::State::WAITING) continue;
+
+            if (slot.cancelRequested.load())
+            {
+                const Wait wait = slot.wait;
+                destroy(slot);
+                releaseSource(wait);
+                continue;
+            }
+
+            Wait& wait = slot.wait;
+            TickType_t now = xTaskGetTickCount();
+            const bool due = (wait.check && wait.check(wait.awaiter)) ||
+                (wait.hasDeadline && !earlier(now, wait.deadline));
+
+            if (due)
+            {
+                const Wait previous = wait;
+                slot.state.store(Slot::State::RUNNING);
+                mCurrent = static_cast<FlowId>(i);
+                wait = {};
+                slot.handle.resume();
+                mCurrent = INVALID_FLOW;
+
+                if (slot.handle.done() || slot.cancelRequested.load())
+                {
+                    const Wait current = wait;
+                    destroy(slot);
+                    releaseSource(previous);
+                    releaseSource(current);
+                    continue;
+                }
+
+                now = xTaskGetTickCount();
+
+                // Ожидание через объект, не зарегистрировавший себя в исполнителе, равносильно yield()
+                if (wait.check == nullptr && !wait.hasDeadline)
+                {
+                    wait = {nullptr, nullptr, now, true, false};
+                }
+                slot.state.store(Slot::State::WAITING);
+                releaseSource(previous);
+
+                // Готовность ожиданий с проверкой выясняется на следующем проходе
+                if (wait.check)
+                {
+                    sleep = 0;
+                    continue;
+                }
+            }
+
+            // Время до срока или до следующего опроса очереди без обработчика отправки
+            if (wait.hasDeadline)
+            {
+                sleep = std::min<TickType_t>(sleep, earlier(now, wait.deadline) ? wait.deadline - now : 0);
+            }
+            if (wait.periodic)
+            {
+                sleep = std::min<TickType_t>(sleep, 1);
+            }
+        }
+
+        if (sleep > 0)
+        {
+            ulTaskNotifyTake(pdTRUE, sleep);
+        }
+        return Thread::LoopAction::CONTINUE;
+    }
+} // namespace esp32_c3::objects
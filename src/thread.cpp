@@ -1,6 +1,7 @@
 #include "esp32_c3_objects/thread.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <esp_err.h>
 #include <esp_log.h>
 
@@ -9,6 +10,7 @@ namespace esp32_c3::objects
     Thread::Thread(const std::string_view name, const uint32_t stackDepth, const UBaseType_t priority) noexcept
         : mStackDepth(stackDepth),
           mPriority(priority),
+          mExited(xSemaphoreCreateBinaryStatic(&mExitedBuffer)),
           mStackWarningThreshold(stackDepth / 10)
     {
         const size_t copySize = std::min(name.size(), THREAD_NAME_SIZE - 1);
@@ -26,9 +28,66 @@ namespace esp32_c3::objects
     Thread::~Thread() noexcept
     {
         stop(false);
+        resetLoopContext();
+        if (const TaskHandle_t parked = mParkedHandle.exchange(nullptr))
+        {
+            vTaskDelete(parked);
+        }
+        if (mExited)
+        {
+            vSemaphoreDelete(mExited);
+        }
     }
 
     esp_err_t Thread::start(LoopFunc loopFunc, const uint32_t intervalMs, const bool startPaused) noexcept
+    {
+        const esp_err_t err = startLoop(std::move(loopFunc), pdMS_TO_TICKS(intervalMs), LoopMode::INTERVAL,
+                                        startPaused);
+        if (err == ESP_OK)
+        {
+            ESP_LOGI(TAG, "Loop task %s started (interval: %" PRIu32 "ms)", mName.data(), intervalMs);
+        }
+        return err;
+    }
+
+    esp_err_t Thread::startEventDriven(LoopFunc loopFunc, const bool startPaused) noexcept
+    {
+        const esp_err_t err = startLoop(std::move(loopFunc), 0, LoopMode::EVENT_DRIVEN, startPaused);
+        if (err == ESP_OK)
+        {
+            ESP_LOGI(TAG, "Loop task %s started (event-driven)", mName.data());
+        }
+        return err;
+    }
+
+    esp_err_t Thread::startPeriodic(LoopFunc loopFunc, const uint32_t periodUs, const bool startPaused) noexcept
+    {
+        constexpr uint32_t tickUs = portTICK_PERIOD_MS * 1000;
+        if (periodUs == 0)
+        {
+            ESP_LOGE(TAG, "Zero period of %s", mName.data());
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (periodUs % tickUs != 0 && periodUs < MIN_TIMER_PERIOD_US)
+        {
+            ESP_LOGE(TAG, "Period %" PRIu32 "us of %s is below %" PRIu32 "us", periodUs, mName.data(),
+                     MIN_TIMER_PERIOD_US);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        // Период, кратный тику, не требует таймера: интервал 0 означает отсчёт через esp_timer
+        const TickType_t interval = periodUs % tickUs == 0 ? periodUs / tickUs : 0;
+        const esp_err_t err = startLoop(std::move(loopFunc), interval, LoopMode::PERIODIC, startPaused, periodUs);
+        if (err == ESP_OK)
+        {
+            ESP_LOGI(TAG, "Loop task %s started (period: %" PRIu32 "us, %s)", mName.data(), periodUs,
+                     interval ? "tick" : "esp_timer");
+        }
+        return err;
+    }
+
+    esp_err_t Thread::startLoop(LoopFunc&& loopFunc, const TickType_t interval, const LoopMode mode,
+                                const bool startPaused, const uint32_t periodUs) noexcept
     {
         TaskHandle_t handle = nullptr;
         if (mHandle.load())
@@ -37,23 +96,48 @@ namespace esp32_c3::objects
             return ESP_ERR_INVALID_STATE;
         }
 
-        mLoopContext.reset(new LoopContext(
+        resetLoopContext();
+        mLoopContext.emplace(
             std::move(loopFunc),
-            pdMS_TO_TICKS(intervalMs),
+            interval,
+            mode,
             this,
             false,
             startPaused
-        ));
+        );
+        mLoopContext->periodUs = periodUs;
+
+        // Сигнал от предыдущего цикла, завершившегося без ожидающего stop()
+        xSemaphoreTake(mExited, 0);
+
+        if (mode == LoopMode::PERIODIC && interval == 0)
+        {
+            // Таймер создаётся здесь, чтобы ошибка вернулась вызывающему; запускает его сама задача
+            const esp_timer_create_args_t args = {
+                .callback = onPeriodTimer,
+                .arg = &*mLoopContext,
+                .dispatch_method = ESP_TIMER_TASK,
+                .name = mName.data(),
+                .skip_unhandled_events = false,
+            };
+            esp_timer_handle_t timer = nullptr;
+            if (const esp_err_t err = esp_timer_create(&args, &timer); err != ESP_OK)
+            {
+                mLoopContext.reset();
+                ESP_LOGE(TAG, "Failed to create period timer for %s: %s", mName.data(), esp_err_to_name(err));
+                return err;
+            }
+            mLoopContext->timer.store(timer);
+        }
 
-        if (xTaskCreate(loopWrapper, mName.data(), mStackDepth, mLoopContext.get(), mPriority, &handle) != pdPASS)
+        if (!createTask(loopWrapper, &*mLoopContext, tskNO_AFFINITY, handle))
         {
+            releasePeriodTimer(*mLoopContext);
             mLoopContext.reset();
             ESP_LOGE(TAG, "Failed to create loop task %s", mName.data());
             return ESP_ERR_NO_MEM;
         }
         mHandle.store(handle);
-
-        ESP_LOGI(TAG, "Loop task %s started (interval: %" PRIu32 "ms)", mName.data(), intervalMs);
         return ESP_OK;
     }
 
@@ -66,7 +150,9 @@ namespace esp32_c3::objects
             return ESP_ERR_INVALID_STATE;
         }
 
-        if (xTaskCreate(taskFunc, mName.data(), mStackDepth, params, mPriority, &handle) == pdPASS)
+        // Контекст завершившегося цикла больше не нужен и не должен влиять на stop()
+        resetLoopContext();
+        if (createTask(taskFunc, params, tskNO_AFFINITY, handle))
         {
             mHandle.store(handle);
             ESP_LOGI(TAG, "Task %s created", mName.data());
@@ -92,15 +178,9 @@ namespace esp32_c3::objects
             return ESP_ERR_INVALID_STATE;
         }
 
-        if (xTaskCreatePinnedToCore(
-            taskFunc,
-            mName.data(),
-            mStackDepth,
-            params,
-            mPriority,
-            &handle,
-            coreId
-        ) == pdPASS)
+        // Контекст завершившегося цикла больше не нужен и не должен влиять на stop()
+        resetLoopContext();
+        if (createTask(taskFunc, params, coreId, handle))
         {
             mHandle.store(handle);
             ESP_LOGI(TAG, "Task %s created on core %d", mName.data(), coreId);
@@ -111,10 +191,25 @@ namespace esp32_c3::objects
         return ESP_ERR_NO_MEM;
     }
 
-    bool Thread::quickStart(const LoopFunc& loopFunc)
+    bool Thread::quickStart(const LoopFunc& loopFunc, const LoopMode mode)
     {
         if (state() != State::NOT_RUNNING) return true;
-        if (start(loopFunc) != ESP_OK)
+
+        esp_err_t err;
+        if (mode == LoopMode::EVENT_DRIVEN)
+        {
+            err = startEventDriven(loopFunc);
+        }
+        else if (mode == LoopMode::PERIODIC)
+        {
+            err = startPeriodic(loopFunc, 10 * 1000); // Период как у start() по умолчанию
+        }
+        else
+        {
+            err = start(loopFunc);
+        }
+
+        if (err != ESP_OK)
         {
             ESP_LOGE(TAG, "Failed to start callback thread");
             return false;
@@ -122,40 +217,39 @@ namespace esp32_c3::objects
         return true;
     }
 
-    // ReSharper disable CppDFAConstantConditions
     void Thread::stop(const bool softStop) noexcept
     {
-        const TaskHandle_t handle = mHandle.exchange(nullptr);
+        TaskHandle_t handle = mHandle.load();
         if (!handle) return;
 
-        if (softStop && mLoopContext)
+        if (mLoopContext && handle == xTaskGetCurrentTaskHandle())
         {
-            mLoopContext->shouldStop = true;
-
-            constexpr TickType_t timeoutStep = pdMS_TO_TICKS(10);
-            const TickType_t end = xTaskGetTickCount() + pdMS_TO_TICKS(1000);
-
-            while (handle && end > xTaskGetTickCount())
-            {
-                vTaskDelay(timeoutStep);
-                // Проверяем, не был ли хендл уже удален в другом потоке
-                if (mHandle.load() == nullptr)
-                {
-                    return;
-                }
-            }
+            mLoopContext->shouldStop.store(true, std::memory_order_release);
+            return;
+        }
 
-            if (handle)
+        if (softStop && mLoopContext)
+        {
+            if (join(handle, pdMS_TO_TICKS(STOP_TIMEOUT_MS)))
             {
-                ESP_LOGW(TAG, "Task %s didn't stop gracefully, forcing stop", mName.data());
-                vTaskDelete(handle);
+                resetLoopContext();
+                return;
             }
+            ESP_LOGW(TAG, "Task %s didn't stop gracefully, forcing stop", mName.data());
         }
-        else
+
+        // Задача могла завершиться сама, пока шло ожидание. Она обнуляет mHandle до сигнала
+        // mExited, поэтому объект можно освобождать только после этого сигнала
+        if (!mHandle.compare_exchange_strong(handle, nullptr))
         {
-            vTaskDelete(handle);
-            ESP_LOGI(TAG, "Task %s forcefully deleted", mName.data());
+            xSemaphoreTake(mExited, portMAX_DELAY);
+            resetLoopContext();
+            return;
         }
+
+        vTaskDelete(handle);
+        resetLoopContext();
+        ESP_LOGI(TAG, "Task %s forcefully deleted", mName.data());
     }
 
     Thread::State Thread::state() const noexcept
@@ -176,6 +270,12 @@ namespace esp32_c3::objects
         }
     }
 
+    bool Thread::isCurrent() const noexcept
+    {
+        const TaskHandle_t handle = mHandle.load();
+        return handle && handle == xTaskGetCurrentTaskHandle();
+    }
+
     void Thread::suspend() const noexcept
     {
         if (const TaskHandle_t handle = mHandle.load())
@@ -246,6 +346,51 @@ namespace esp32_c3::objects
         return mName.data();
     }
 
+    Thread::PeriodStats Thread::periodStats(const bool reset) noexcept
+    {
+        PeriodStats stats;
+        const auto take = [reset](auto& counter) { return reset ? counter.exchange(0) : counter.load(); };
+
+        stats.iterations = take(mPeriodIterations);
+        stats.overruns = take(mPeriodOverruns);
+        stats.maxJitterUs = take(mMaxJitterUs);
+        const uint64_t jitterSum = take(mJitterSumUs);
+
+        if (const uint32_t samples = stats.iterations - stats.overruns; samples > 0)
+        {
+            stats.avgJitterUs = static_cast<uint32_t>(jitterSum / samples);
+        }
+        return stats;
+    }
+
+    bool Thread::createTask(const TaskFunction_t taskFunc, void* params, const BaseType_t coreId,
+                            TaskHandle_t& handle) noexcept
+    {
+        if (!mStaticStack)
+        {
+            const BaseType_t result = coreId == tskNO_AFFINITY
+                                          ? xTaskCreate(taskFunc, mName.data(), mStackDepth, params, mPriority,
+                                                        &handle)
+                                          : xTaskCreatePinnedToCore(taskFunc, mName.data(), mStackDepth, params,
+                                                                    mPriority, &handle, coreId);
+            return result == pdPASS;
+        }
+
+        // Завершившая цикл задача припаркована: удаление из другой задачи освобождает TCB сразу,
+        // поэтому хранилище можно использовать повторно
+        if (const TaskHandle_t parked = mParkedHandle.exchange(nullptr))
+        {
+            vTaskDelete(parked);
+        }
+
+        handle = coreId == tskNO_AFFINITY
+                     ? xTaskCreateStatic(taskFunc, mName.data(), mStackDepth, params, mPriority,
+                                         mStaticStack, mStaticTcb)
+                     : xTaskCreateStaticPinnedToCore(taskFunc, mName.data(), mStackDepth, params, mPriority,
+                                                     mStaticStack, mStaticTcb, coreId);
+        return handle != nullptr;
+    }
+
     void Thread::loopWrapper(void* arg) noexcept
     {
         if (!arg)
@@ -261,6 +406,22 @@ namespace esp32_c3::objects
             ctx->thread->suspend();
         }
 
+        if (ctx->mode == LoopMode::PERIODIC)
+        {
+            ctx->task = xTaskGetCurrentTaskHandle();
+            if (const esp_timer_handle_t timer = ctx->timer.load())
+            {
+                if (const esp_err_t err = esp_timer_start_periodic(timer, ctx->periodUs); err != ESP_OK)
+                {
+                    // Без таймера ожидание периода никогда не закончится: цикл завершается сразу
+                    ESP_LOGE(TAG, "Failed to start period timer of %s: %s", ctx->thread->mName.data(),
+                             esp_err_to_name(err));
+                    ctx->shouldStop.store(true, std::memory_order_release);
+                }
+            }
+            restartPeriod(*ctx);
+        }
+
         while (!ctx->shouldStop.load(std::memory_order_relaxed))
         {
             // Автоматическая проверка стека
@@ -270,13 +431,33 @@ namespace esp32_c3::objects
 
             if (action == LoopAction::CONTINUE)
             {
-                vTaskDelay(ctx->interval);
+                // В событийном режиме ожидание уже выполнено внутри функции цикла
+                if (ctx->mode == LoopMode::INTERVAL)
+                {
+                    // Ожидание на уведомлении прерывается остановкой, в отличие от vTaskDelay
+                    if (ctx->interval > 0)
+                    {
+                        ulTaskNotifyTakeIndexed(THREAD_NOTIFY_INDEX, pdTRUE, ctx->interval);
+                    }
+                    else
+                    {
+                        vTaskDelay(0);
+                    }
+                }
+                else if (ctx->mode == LoopMode::PERIODIC)
+                {
+                    waitPeriod(*ctx);
+                }
                 continue;
             }
 
             if (action == LoopAction::PAUSE)
             {
                 ctx->thread->suspend();
+                if (ctx->mode == LoopMode::PERIODIC)
+                {
+                    restartPeriod(*ctx);
+                }
                 continue;
             }
 
@@ -287,7 +468,152 @@ namespace esp32_c3::objects
             }
         }
 
-        ctx->thread->mHandle = nullptr;
+        releasePeriodTimer(*ctx);
+
+        Thread* thread = ctx->thread;
+        const bool isStatic = thread->mStaticStack != nullptr;
+        if (isStatic)
+        {
+            // Самоудалённая статическая задача ждёт очистки idle-задачей, и до этого её TCB
+            // нельзя переиспользовать. Поэтому задача паркуется, а удаляется при следующем запуске
+            thread->mParkedHandle = xTaskGetCurrentTaskHandle();
+        }
+        thread->mHandle = nullptr;
+
+        // После сигнала объект Thread может быть уже уничтожен ожидающим stop()
+        xSemaphoreGive(thread->mExited);
+        if (isStatic)
+        {
+            vTaskSuspend(nullptr);
+        }
         vTaskDelete(nullptr);
     }
+
+    bool Thread::join(const TaskHandle_t handle, TickType_t timeout) noexcept
+    {
+        mLoopContext->shouldStop.store(true, std::memory_order_release);
+
+        TimeOut_t timeOut;
+        vTaskSetTimeOutState(&timeOut);
+
+        // Задача могла проверить флаг непосредственно перед его установкой и заблокироваться уже
+        // после пробуждения, поэтому пробуждение повторяется каждый тик до сигнала завершения
+        while (true)
+        {
+            // Задача обнуляет mHandle до сигнала: после этого её TCB может быть уже освобождён
+            if (mHandle.load())
+            {
+                wake(handle);
+            }
+            if (xSemaphoreTake(mExited, 1) == pdTRUE) return true;
+            if (xTaskCheckForTimeOut(&timeOut, &timeout) != pdFALSE) return false;
+        }
+    }
+
+    void Thread::setWakeHook(WakeFunc hook) noexcept
+    {
+        mWakeHook = std::move(hook);
+    }
+
+    void Thread::wake(const TaskHandle_t handle) const noexcept
+    {
+        if (eTaskGetState(handle) == eSuspended)
+        {
+            vTaskResume(handle);
+        }
+
+        // Прерываются только ожидания самого Thread и источника событий функции цикла.
+        // Чужие блокирующие вызовы (мьютексы, очереди пользователя) не затрагиваются
+        xTaskNotifyGiveIndexed(handle, THREAD_NOTIFY_INDEX);
+        if (mWakeHook)
+        {
+            mWakeHook();
+        }
+    }
+
+    void Thread::restartPeriod(LoopContext& ctx) noexcept
+    {
+        // Срабатывания таймера за время приостановки не должны вызвать серию итераций
+        ulTaskNotifyTakeIndexed(THREAD_NOTIFY_INDEX, pdTRUE, 0);
+        ctx.lastWake = xTaskGetTickCount();
+        ctx.lastWakeUs = esp_timer_get_time();
+    }
+
+    void Thread::waitPeriod(LoopContext& ctx) noexcept
+    {
+        bool overrun;
+        if (ctx.interval == 0)
+        {
+            // Накопилось больше одного уведомления - таймер сработал, пока выполнялось тело цикла
+            overrun = ulTaskNotifyTakeIndexed(THREAD_NOTIFY_INDEX, pdTRUE, portMAX_DELAY) > 1;
+        }
+        else
+        {
+            // Отсчёт как у xTaskDelayUntil, но ожидание на уведомлении прерывается остановкой
+            TickType_t elapsed = xTaskGetTickCount() - ctx.lastWake;
+            overrun = elapsed > ctx.interval;
+            if (overrun)
+            {
+                // Пропущенные периоды не догоняются: расписание продолжается от текущего тика
+                ctx.lastWake += elapsed;
+            }
+            else
+            {
+                while (elapsed < ctx.interval && !ctx.shouldStop.load(std::memory_order_relaxed))
+                {
+                    ulTaskNotifyTakeIndexed(THREAD_NOTIFY_INDEX, pdTRUE, ctx.interval - elapsed);
+                    elapsed = xTaskGetTickCount() - ctx.lastWake;
+                }
+                ctx.lastWake += ctx.interval;
+            }
+        }
+
+        // Ожидание прервано остановкой - итерация не учитывается
+        if (ctx.shouldStop.load(std::memory_order_relaxed)) return;
+
+        const int64_t now = esp_timer_get_time();
+        const int64_t elapsed = now - ctx.lastWakeUs;
+        ctx.lastWakeUs = now;
+
+        Thread& thread = *ctx.thread;
+        thread.mPeriodIterations.fetch_add(1, std::memory_order_relaxed);
+        if (overrun)
+        {
+            thread.mPeriodOverruns.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const auto jitter = static_cast<uint32_t>(std::abs(elapsed - static_cast<int64_t>(ctx.periodUs)));
+        thread.mJitterSumUs.fetch_add(jitter, std::memory_order_relaxed);
+        if (jitter > thread.mMaxJitterUs.load(std::memory_order_relaxed))
+        {
+            thread.mMaxJitterUs.store(jitter, std::memory_order_relaxed);
+        }
+    }
+
+    void Thread::onPeriodTimer(void* arg) noexcept
+    {
+        if (const TaskHandle_t task = static_cast<LoopContext*>(arg)->task)
+        {
+            xTaskNotifyGiveIndexed(task, THREAD_NOTIFY_INDEX);
+        }
+    }
+
+    void Thread::resetLoopContext() noexcept
+    {
+        if (mLoopContext)
+        {
+            releasePeriodTimer(*mLoopContext);
+            mLoopContext.reset();
+        }
+    }
+
+    void Thread::releasePeriodTimer(LoopContext& ctx) noexcept
+    {
+        if (const esp_timer_handle_t timer = ctx.timer.exchange(nullptr))
+        {
+            esp_timer_stop(timer);
+            esp_timer_delete(timer);
+        }
+    }
 } // namespace esp32_c3::objects
@@ -0,0 +1,18 @@
+// Завершение программы теста на цели linux.
+// После возврата из app_main() планировщик FreeRTOS продолжает работать, поэтому процесс
+// завершается явно с кодом по результату Unity: иначе запуск теста никогда бы не закончился.
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <unity.h>
+
+extern "C" void __real_app_main();
+
+extern "C" void __wrap_app_main()
+{
+    __real_app_main();
+
+    std::fflush(stdout);
+    std::exit(Unity.TestFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
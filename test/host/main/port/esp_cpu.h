@@ -0,0 +1,19 @@
+#ifndef ESP32_C3_HOST_ESP_CPU_H
+#define ESP32_C3_HOST_ESP_CPU_H
+
+// esp_cpu.h для цели linux: esp_hw_support там не собирается, а статистика обработчиков
+// и очередей измеряет время в тактах. Такт заменён наносекундой монотонных часов.
+
+#include <stdint.h>
+#include <time.h>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+static inline esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (esp_cpu_cycle_count_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+}
+
+#endif // ESP32_C3_HOST_ESP_CPU_H
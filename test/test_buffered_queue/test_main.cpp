@@ -0,0 +1,157 @@
+// Стоимость BufferedQueue в тактах: учёт свободных слотов отдельной очередью FreeRTOS
+// против атомарной битовой карты (на сообщение и на создание очереди), а также задержка
+// пробуждения отправителя, ожидающего свободного слота битовой карты.
+
+#include "esp32_c3_objects/buffered_queue.h"
+#include "esp32_c3_objects/thread.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+
+#include <esp_cpu.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr size_t BUFFER_SIZE = 64;
+    constexpr uint32_t MESSAGES = 2000;
+    constexpr uint32_t CONSTRUCTIONS = 20;
+    constexpr size_t WAKE_SAMPLES = 11;
+
+    /// Задержка пробуждения значительно меньше периода тика
+    constexpr int64_t MAX_MEDIAN_WAKE_US = 1000000 / configTICK_RATE_HZ / 10;
+
+    /// Сообщение среднего размера
+    struct Message
+    {
+        uint32_t seq = 0;
+        uint8_t payload[28]{};
+    };
+
+    /// Результат измерения
+    struct Cost
+    {
+        uint32_t perMessage = 0;      ///< Тактов на пару send/receive
+        uint32_t perConstruction = 0; ///< Тактов на создание и уничтожение очереди
+    };
+
+    template <FreeSlotTracking Tracking>
+    Cost measure()
+    {
+        using Queue = BufferedQueue<Message, BUFFER_SIZE, Tracking>;
+
+        Cost cost;
+        {
+            Queue queue(BUFFER_SIZE);
+            TEST_ASSERT_TRUE(queue.isValid());
+
+            // Очередь наполовину заполнена, чтобы слоты не освобождались сразу же
+            Message message;
+            for (uint32_t i = 0; i < BUFFER_SIZE / 2; ++i)
+            {
+                message.seq = i;
+                TEST_ASSERT_TRUE(queue.send(message, 0));
+            }
+
+            const auto start = esp_cpu_get_cycle_count();
+            for (uint32_t i = 0; i < MESSAGES; ++i)
+            {
+                message.seq = i;
+                queue.send(message, 0);
+                queue.receive(message, 0);
+            }
+            cost.perMessage = static_cast<uint32_t>(esp_cpu_get_cycle_count() - start) / MESSAGES;
+            TEST_ASSERT_EQUAL(BUFFER_SIZE / 2, queue.waiting());
+        }
+
+        std::optional<Queue> queue;
+        const auto start = esp_cpu_get_cycle_count();
+        for (uint32_t i = 0; i < CONSTRUCTIONS; ++i)
+        {
+            queue.emplace(BUFFER_SIZE);
+            queue.reset();
+        }
+        cost.perConstruction = static_cast<uint32_t>(esp_cpu_get_cycle_count() - start) / CONSTRUCTIONS;
+        return cost;
+    }
+
+    void test_bitmap_tracking_is_cheaper()
+    {
+        const Cost queue = measure<FreeSlotTracking::QUEUE>();
+        const Cost bitmap = measure<FreeSlotTracking::BITMAP>();
+        std::printf("send+receive: queue tracking %lu cycles, bitmap %lu cycles\n",
+                    static_cast<unsigned long>(queue.perMessage), static_cast<unsigned long>(bitmap.perMessage));
+        std::printf("construction (%u slots): queue tracking %lu cycles, bitmap %lu cycles\n",
+                    static_cast<unsigned>(BUFFER_SIZE), static_cast<unsigned long>(queue.perConstruction),
+                    static_cast<unsigned long>(bitmap.perConstruction));
+
+        TEST_ASSERT_TRUE(bitmap.perMessage < queue.perMessage);
+        TEST_ASSERT_TRUE(bitmap.perConstruction < queue.perConstruction);
+    }
+
+    void test_bitmap_wait_wakes_on_release()
+    {
+        constexpr size_t SLOTS = 4;
+        BufferedQueue<uint32_t, SLOTS, FreeSlotTracking::BITMAP> queue(SLOTS);
+        TEST_ASSERT_TRUE(queue.isValid());
+
+        std::atomic<int64_t> sentAt{0};
+        std::atomic<bool> timedOut{false};
+        Thread producer("producer", 3072, 10);
+        TEST_ASSERT_TRUE(producer.quickStart([&]
+        {
+            // Буфер заполнен, поэтому отправка ждёт освобождения слота
+            if (!queue.send(0, portMAX_DELAY)) return Thread::LoopAction::STOP;
+            sentAt.store(esp_timer_get_time());
+
+            // Ожидание без освобождения слота завершается по таймауту
+            if (queue.available() == 0 && !queue.send(0, 1)) timedOut.store(true);
+            return Thread::LoopAction::CONTINUE;
+        }, Thread::LoopMode::EVENT_DRIVEN));
+
+        std::array<int64_t, WAKE_SAMPLES> wake{};
+        for (auto& sample : wake)
+        {
+            while (queue.available() > 0 || queue.waiting() < SLOTS) vTaskDelay(1);
+            vTaskDelay(pdMS_TO_TICKS(20));
+
+            // Слот освобождается между тиками, а не сразу после пробуждения по тику
+            const int64_t tickStart = esp_timer_get_time();
+            while (esp_timer_get_time() - tickStart < 1000000 / configTICK_RATE_HZ / 3) {}
+
+            sentAt.store(0);
+            const int64_t released = esp_timer_get_time();
+            uint32_t item;
+            TEST_ASSERT_TRUE(queue.receive(item, 0));
+            while (sentAt.load() == 0) vTaskDelay(1);
+            sample = sentAt.load() - released;
+        }
+        producer.stop();
+        std::sort(wake.begin(), wake.end());
+
+        std::printf("bitmap slot wait: wake median %lld us, max %lld us\n",
+                    static_cast<long long>(wake[WAKE_SAMPLES / 2]), static_cast<long long>(wake.back()));
+        TEST_ASSERT_TRUE(timedOut.load());
+        TEST_ASSERT_TRUE(wake[WAKE_SAMPLES / 2] < MAX_MEDIAN_WAKE_US);
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_bitmap_tracking_is_cheaper);
+    RUN_TEST(test_bitmap_wait_wakes_on_release);
+    UNITY_END();
+}
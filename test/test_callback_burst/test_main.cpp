@@ -0,0 +1,161 @@
+// Пачки событий Callback больше прежнего фиксированного буфера из 5 элементов.
+// Обработчик задерживается до конца пачки, поэтому все её события должны поместиться в очередь:
+// если бы очередь оказалась короче, отправитель заблокировался бы в invoke().
+
+#include "esp32_c3_objects/callback.h"
+#include "esp32_c3_objects/thread.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr uint8_t CAPACITY = 32;
+    constexpr uint8_t BURST = 24;
+    constexpr uint8_t STATIC_BURST = 16;
+
+    using BurstCallback = Callback<uint32_t, 0, CAPACITY>;
+
+    /// Журнал обработанных событий с задержкой обработчика
+    struct Log
+    {
+        std::array<uint32_t, CAPACITY> values{};
+        std::atomic<uint8_t> count{0};
+        std::atomic<bool> open{false};
+
+        bool add(const uint32_t value)
+        {
+            while (!open.load()) vTaskDelay(1);
+
+            const uint8_t i = count.load();
+            if (i < values.size())
+            {
+                values[i] = value;
+                count.store(i + 1);
+            }
+            return false;
+        }
+    };
+
+    /// Отправить пачку из отдельного потока и проверить, что отправка не заблокировалась
+    void sendBurst(BurstCallback& callback, Log& log, const uint8_t size)
+    {
+        log.open.store(false);
+        log.count.store(0);
+
+        std::atomic<bool> sent{false};
+        Thread producer("producer", 3072, BurstCallback::DEFAULT_PRIORITY);
+        TEST_ASSERT_TRUE(producer.quickStart([&]
+        {
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                callback.invoke(i);
+            }
+            sent.store(true);
+            return Thread::LoopAction::STOP;
+        }, Thread::LoopMode::EVENT_DRIVEN));
+
+        for (int i = 0; i < 50 && !sent.load(); ++i) vTaskDelay(pdMS_TO_TICKS(10));
+        const bool completed = sent.load();
+
+        // Обработчик отпускается в любом случае, чтобы заблокированный отправитель мог завершиться
+        log.open.store(true);
+        while (!sent.load()) vTaskDelay(1);
+        producer.stop();
+
+        TEST_ASSERT_TRUE(completed);
+    }
+
+    /// Дождаться обработки пачки и проверить порядок
+    void checkBurst(const Log& log, const uint8_t size)
+    {
+        for (int i = 0; i < 100 && log.count.load() < size; ++i) vTaskDelay(pdMS_TO_TICKS(10));
+
+        TEST_ASSERT_EQUAL(size, log.count.load());
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            TEST_ASSERT_EQUAL(i, log.values[i]);
+        }
+    }
+
+    void test_burst_fits_runtime_buffer()
+    {
+        Log log;
+        BurstCallback callback("burst", BURST);
+        TEST_ASSERT_TRUE(callback.isInitialized());
+        TEST_ASSERT_EQUAL(0, callback.addCallback([&log](const uint32_t& value, uint32_t&)
+        {
+            return log.add(value);
+        }));
+
+        sendBurst(callback, log, BURST);
+        checkBurst(log, BURST);
+    }
+
+    void test_burst_fits_static_storage()
+    {
+        static BurstCallback::Storage<1, BurstCallback::DEFAULT_STACK_DEPTH, STATIC_BURST> storage;
+
+        Log log;
+        BurstCallback callback("burst", storage);
+        TEST_ASSERT_TRUE(callback.isInitialized());
+        TEST_ASSERT_EQUAL(0, callback.addCallback([&log](const uint32_t& value, uint32_t&)
+        {
+            return log.add(value);
+        }));
+
+        sendBurst(callback, log, STATIC_BURST);
+        checkBurst(log, STATIC_BURST);
+    }
+
+    void test_repeated_bursts()
+    {
+        Log log;
+        BurstCallback callback("burst", BURST);
+        TEST_ASSERT_EQUAL(0, callback.addCallback([&log](const uint32_t& value, uint32_t&)
+        {
+            return log.add(value);
+        }));
+
+        sendBurst(callback, log, BURST);
+        checkBurst(log, BURST);
+
+        // Второй пачке снова доступна вся очередь
+        sendBurst(callback, log, BURST);
+        checkBurst(log, BURST);
+    }
+
+    void test_buffer_size_above_capacity_fails()
+    {
+        // Размер больше ёмкости не урезается: объект остаётся неработоспособным
+        Callback<uint32_t, 0, 4> small("small", 8);
+        TEST_ASSERT_FALSE(small.isInitialized());
+        TEST_ASSERT_FALSE(small.invokeAndWait(1, 0).has_value());
+
+        Callback<uint32_t, 0, 4, 2> lanes("lanes", 8);
+        TEST_ASSERT_FALSE(lanes.isInitialized());
+
+        Callback<uint32_t, 0, 4> exact("exact", 4);
+        TEST_ASSERT_TRUE(exact.isInitialized());
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_burst_fits_runtime_buffer);
+    RUN_TEST(test_burst_fits_static_storage);
+    RUN_TEST(test_repeated_bursts);
+    RUN_TEST(test_buffer_size_above_capacity_fails);
+    UNITY_END();
+}
@@ -0,0 +1,133 @@
+// Объединение повторяющихся событий Callback и сброс таблицы объединения вызовом setCoalescing(),
+// пока события ещё ожидают в очереди.
+
+#include "esp32_c3_objects/callback.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr int WAIT_STEPS = 100;
+
+    /// Ключ события - сотни значения
+    uint32_t keyOf(const uint32_t& value)
+    {
+        return value / 100;
+    }
+
+    /// Журнал обработанных событий; событие 0 задерживает обработчик до открытия
+    struct Log
+    {
+        std::array<uint32_t, 8> values{};
+        std::atomic<uint8_t> count{0};
+        std::atomic<bool> entered{false};
+        std::atomic<bool> open{false};
+
+        bool add(const uint32_t value)
+        {
+            if (value == 0)
+            {
+                entered.store(true);
+                while (!open.load()) vTaskDelay(1);
+                return false;
+            }
+
+            const uint8_t i = count.load();
+            if (i < values.size())
+            {
+                values[i] = value;
+                count.store(i + 1);
+            }
+            return false;
+        }
+    };
+
+    /// Занять обработчик, чтобы следующие события ждали в очереди
+    void hold(Callback<uint32_t>& callback, Log& log)
+    {
+        TEST_ASSERT_EQUAL(0, callback.addCallback([&log](const uint32_t& value, uint32_t&)
+        {
+            return log.add(value);
+        }));
+        callback.invoke(0);
+        for (int i = 0; i < WAIT_STEPS && !log.entered.load(); ++i) vTaskDelay(1);
+        TEST_ASSERT_TRUE(log.entered.load());
+    }
+
+    void waitCount(const Log& log, const uint8_t count)
+    {
+        for (int i = 0; i < WAIT_STEPS && log.count.load() < count; ++i) vTaskDelay(pdMS_TO_TICKS(10));
+        vTaskDelay(pdMS_TO_TICKS(20));
+        TEST_ASSERT_EQUAL(count, log.count.load());
+    }
+
+    void test_repeated_key_is_coalesced()
+    {
+        Log log;
+        Callback<uint32_t> callback("coalesce");
+        hold(callback, log);
+
+        callback.setCoalescing(keyOf);
+        callback.invoke(101);
+        callback.invoke(102);
+        callback.invoke(201);
+        log.open.store(true);
+
+        waitCount(log, 2);
+        TEST_ASSERT_EQUAL(102, log.values[0]);
+        TEST_ASSERT_EQUAL(201, log.values[1]);
+    }
+
+    void test_reset_with_pending_events_keeps_keys_apart()
+    {
+        Log log;
+        Callback<uint32_t> callback("coalesce");
+        hold(callback, log);
+
+        callback.setCoalescing(keyOf);
+        callback.invoke(101);
+        callback.invoke(102);
+
+        // Новая таблица отдаёт освободившуюся запись другому ключу, пока событие 101 ещё в очереди
+        callback.setCoalescing(keyOf);
+        callback.invoke(201);
+        log.open.store(true);
+
+        // Событие старого поколения обрабатывается со своими исходными данными
+        waitCount(log, 2);
+        TEST_ASSERT_EQUAL(101, log.values[0]);
+        TEST_ASSERT_EQUAL(201, log.values[1]);
+
+        // Записи нового поколения по-прежнему объединяют повторы
+        log.count.store(0);
+        log.open.store(false);
+        log.entered.store(false);
+        callback.invoke(0);
+        for (int i = 0; i < WAIT_STEPS && !log.entered.load(); ++i) vTaskDelay(1);
+        callback.invoke(301);
+        callback.invoke(302);
+        log.open.store(true);
+
+        waitCount(log, 1);
+        TEST_ASSERT_EQUAL(302, log.values[0]);
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_repeated_key_is_coalesced);
+    RUN_TEST(test_reset_with_pending_events_keeps_keys_apart);
+    UNITY_END();
+}
@@ -0,0 +1,173 @@
+// Скорость диспетчеризации Callback и число выделений памяти в куче на событие.
+// Для сравнения через ту же очередь измеряется прежняя схема: блокировка таблицы и копирование
+// подходящих функций в новый std::vector на каждое событие.
+
+#include "esp32_c3_objects/callback.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+namespace
+{
+    std::atomic<uint32_t> allocations{0};
+}
+
+// Подсчёт выделений памяти через operator new (std::function, std::vector и т.п.)
+void* operator new(const std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* block = std::malloc(size ? size : 1)) return block;
+    std::abort();
+}
+
+void operator delete(void* block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept
+{
+    std::free(block);
+}
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr uint32_t EVENTS = 2000;
+    constexpr uint8_t HANDLERS = 4;
+    constexpr int64_t TIMEOUT_US = 10 * 1000 * 1000;
+
+    /// Результат измерения
+    struct Result
+    {
+        uint32_t eventsPerSecond = 0;    ///< Пропускная способность
+        uint32_t allocationsPer1000 = 0; ///< Выделений памяти на 1000 событий
+    };
+
+    void report(const char* name, const Result& result)
+    {
+        std::printf("%s: %lu ev/s, %lu allocations per 1000 events\n", name,
+                    static_cast<unsigned long>(result.eventsPerSecond),
+                    static_cast<unsigned long>(result.allocationsPer1000));
+    }
+
+    template <typename CallbackType>
+    Result measureCallback()
+    {
+        std::atomic<uint32_t> calls{0};
+        CallbackType callback("dispatch", CallbackType::DEFAULT_BUFFER_SIZE, HANDLERS);
+        for (uint8_t i = 0; i < HANDLERS; ++i)
+        {
+            TEST_ASSERT_EQUAL(i, callback.addCallback([&calls](const uint32_t&, uint32_t&)
+            {
+                calls.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }));
+        }
+
+        const uint32_t target = EVENTS * HANDLERS;
+        const uint32_t before = allocations.load();
+        const int64_t start = esp_timer_get_time();
+        for (uint32_t i = 0; i < EVENTS; ++i)
+        {
+            callback.invoke(i);
+        }
+        while (calls.load() < target && esp_timer_get_time() - start < TIMEOUT_US) vTaskDelay(1);
+        const int64_t elapsed = esp_timer_get_time() - start;
+        const uint32_t allocated = allocations.load() - before;
+
+        TEST_ASSERT_EQUAL(target, calls.load());
+        return {static_cast<uint32_t>(EVENTS * 1000000LL / elapsed), allocated * 1000 / EVENTS};
+    }
+
+    /// Прежняя схема: единственная функция Callback блокирует таблицу и копирует её на каждое событие
+    Result measureCopyingDispatch()
+    {
+        struct Item
+        {
+            bool onlyIndex = false;
+            std::function<bool(const uint32_t&, uint32_t&)> func;
+        };
+
+        std::atomic<uint32_t> calls{0};
+        std::mutex mutex;
+        std::vector<Item> table;
+        for (uint8_t i = 0; i < HANDLERS; ++i)
+        {
+            table.push_back({false, [&calls](const uint32_t&, uint32_t&)
+            {
+                calls.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }});
+        }
+
+        Callback<uint32_t> callback("dispatch", Callback<uint32_t>::DEFAULT_BUFFER_SIZE, 1);
+        TEST_ASSERT_EQUAL(0, callback.addCallback([&](const uint32_t& input, uint32_t&)
+        {
+            std::vector<Item> snapshot;
+            {
+                std::lock_guard lock(mutex);
+                for (const Item& item : table)
+                {
+                    if (!item.onlyIndex) snapshot.push_back(item);
+                }
+            }
+            for (const Item& item : snapshot)
+            {
+                uint32_t output;
+                item.func(input, output);
+            }
+            return false;
+        }));
+
+        const uint32_t target = EVENTS * HANDLERS;
+        const uint32_t before = allocations.load();
+        const int64_t start = esp_timer_get_time();
+        for (uint32_t i = 0; i < EVENTS; ++i)
+        {
+            callback.invoke(i);
+        }
+        while (calls.load() < target && esp_timer_get_time() - start < TIMEOUT_US) vTaskDelay(1);
+        const int64_t elapsed = esp_timer_get_time() - start;
+        const uint32_t allocated = allocations.load() - before;
+
+        TEST_ASSERT_EQUAL(target, calls.load());
+        return {static_cast<uint32_t>(EVENTS * 1000000LL / elapsed), allocated * 1000 / EVENTS};
+    }
+
+    void test_dispatch_does_not_allocate()
+    {
+        const Result copying = measureCopyingDispatch();
+        const Result function = measureCallback<Callback<uint32_t>>();
+        const Result inplace = measureCallback<Callback<uint32_t, 32>>();
+        report("copying dispatch (previous scheme)", copying);
+        report("Callback<std::function>", function);
+        report("Callback<InplaceFunction>", inplace);
+
+        TEST_ASSERT_TRUE(copying.allocationsPer1000 >= 1000);
+        TEST_ASSERT_EQUAL(0, function.allocationsPer1000);
+        TEST_ASSERT_EQUAL(0, inplace.allocationsPer1000);
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_dispatch_does_not_allocate);
+    UNITY_END();
+}
@@ -0,0 +1,134 @@
+// Отмена ожидающих вызовов при удалении заданий из очереди Callback: free() и деструктор
+// не должны оставлять invokeAndWait() и Future::wait() в вечном ожидании.
+
+#include "esp32_c3_objects/callback.h"
+#include "esp32_c3_objects/thread.h"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr TickType_t BUSY_TICKS = pdMS_TO_TICKS(200);
+    constexpr int WAIT_STEPS = 100;
+
+    /// Состояние вызова invokeAndWait() из отдельного потока
+    struct Waiter
+    {
+        std::atomic<bool> started{false};
+        std::atomic<bool> returned{false};
+        std::atomic<bool> hasValue{false};
+    };
+
+    /// Обработчик, занятый первым событием, пока остальные ждут в очереди
+    template <typename CallbackType>
+    void addBusyHandler(CallbackType& callback, std::atomic<bool>& entered)
+    {
+        TEST_ASSERT_EQUAL(0, callback.addCallback([&entered](const uint32_t& value, uint32_t& output)
+        {
+            if (!entered.exchange(true)) vTaskDelay(BUSY_TICKS);
+            output = value;
+            return true;
+        }));
+    }
+
+    /// Вызов free(), пока invokeAndWait() ждёт в очереди уровня lane
+    template <typename CallbackType>
+    void freeWhileWaiting(CallbackType& callback, const uint8_t lane)
+    {
+        std::atomic<bool> entered{false};
+        addBusyHandler(callback, entered);
+
+        callback.invoke(1);
+        for (int i = 0; i < WAIT_STEPS && !entered.load(); ++i) vTaskDelay(1);
+        TEST_ASSERT_TRUE(entered.load());
+
+        Waiter waiter;
+        Thread thread("waiter", 3072, CallbackType::DEFAULT_PRIORITY);
+        TEST_ASSERT_TRUE(thread.quickStart([&]
+        {
+            waiter.started.store(true);
+            waiter.hasValue.store(callback.invokeAndWait(2, portMAX_DELAY, -1, lane).has_value());
+            waiter.returned.store(true);
+            return Thread::LoopAction::STOP;
+        }, Thread::LoopMode::EVENT_DRIVEN));
+
+        // Задание ставится в очередь, пока обработчик занят первым событием
+        while (!waiter.started.load()) vTaskDelay(1);
+        vTaskDelay(pdMS_TO_TICKS(20));
+        callback.free();
+
+        for (int i = 0; i < WAIT_STEPS && !waiter.returned.load(); ++i) vTaskDelay(pdMS_TO_TICKS(10));
+        TEST_ASSERT_TRUE(waiter.returned.load());
+        TEST_ASSERT_FALSE(waiter.hasValue.load());
+        thread.stop();
+    }
+
+    void test_free_cancels_pending_invoke_and_wait()
+    {
+        Callback<uint32_t> callback("future");
+        TEST_ASSERT_TRUE(callback.isInitialized());
+        freeWhileWaiting(callback, 0);
+    }
+
+    void test_free_cancels_pending_invoke_and_wait_in_lane()
+    {
+        Callback<uint32_t, 0, 5, 2> callback("future");
+        TEST_ASSERT_TRUE(callback.isInitialized());
+        freeWhileWaiting(callback, 1);
+    }
+
+    void test_destructor_cancels_pending_future()
+    {
+        using TestCallback = Callback<uint32_t>;
+
+        TestCallback::Future future;
+        {
+            std::atomic<bool> entered{false};
+            TestCallback callback("future");
+            addBusyHandler(callback, entered);
+
+            callback.invoke(1);
+            for (int i = 0; i < WAIT_STEPS && !entered.load(); ++i) vTaskDelay(1);
+            TEST_ASSERT_TRUE(callback.invokeAsync(2, future));
+        }
+
+        // Менеджер уничтожен: задание удалено, ожидание завершается сразу
+        TEST_ASSERT_FALSE(future.wait(portMAX_DELAY).has_value());
+        TEST_ASSERT_FALSE(future.ready());
+    }
+
+    void test_invoke_and_wait_after_free()
+    {
+        Callback<uint32_t> callback("future");
+        std::atomic<bool> entered{false};
+        addBusyHandler(callback, entered);
+
+        // После free() менеджер снова принимает вызовы, и результат возвращается как обычно
+        callback.free();
+        addBusyHandler(callback, entered);
+        const std::optional<uint32_t> result = callback.invokeAndWait(7, pdMS_TO_TICKS(1000));
+        TEST_ASSERT_TRUE(result.has_value());
+        TEST_ASSERT_EQUAL(7, *result);
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_free_cancels_pending_invoke_and_wait);
+    RUN_TEST(test_free_cancels_pending_invoke_and_wait_in_lane);
+    RUN_TEST(test_destructor_cancels_pending_future);
+    RUN_TEST(test_invoke_and_wait_after_free);
+    UNITY_END();
+}
@@ -0,0 +1,107 @@
+// Задержка срочных событий Callback под насыщающей нагрузкой младшего уровня.
+// Срочные события идут либо в старший уровень, либо (для сравнения) в ту же очередь, что и фон.
+
+#include "esp32_c3_objects/callback.h"
+#include "esp32_c3_objects/thread.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr uint8_t QUEUE_LENGTH = 16;
+    constexpr size_t SAMPLES = 100;
+    constexpr int64_t HANDLER_US = 200;
+    constexpr int64_t P99_BUDGET_US = 2000;
+
+    struct Event
+    {
+        int64_t stamp = 0;
+        bool urgent = false;
+    };
+
+    using LaneCallback = Callback<Event, 32, QUEUE_LENGTH, 2>;
+
+    void spin(const int64_t us)
+    {
+        const int64_t end = esp_timer_get_time() + us;
+        while (esp_timer_get_time() < end) {}
+    }
+
+    /// Измерить p99 задержки срочных событий, отправляемых в уровень urgentLane
+    int64_t measureP99(const uint8_t urgentLane)
+    {
+        std::array<int64_t, SAMPLES> latency{};
+        std::atomic<size_t> count{0};
+
+        LaneCallback callback("lanes", QUEUE_LENGTH, 1);
+        callback.addCallback([&](const Event& event, Event&)
+        {
+            if (event.urgent)
+            {
+                if (const size_t i = count.load(); i < SAMPLES)
+                {
+                    latency[i] = esp_timer_get_time() - event.stamp;
+                    count.store(i + 1);
+                }
+            }
+            spin(HANDLER_US);
+            return false;
+        });
+
+        // Фон выше рабочего потока по приоритету, поэтому очередь младшего уровня всегда заполнена
+        Thread flood("flood", 3072, LaneCallback::DEFAULT_PRIORITY + 1);
+        TEST_ASSERT_TRUE(flood.quickStart([&]
+        {
+            callback.invoke(Event{esp_timer_get_time(), false});
+            return Thread::LoopAction::CONTINUE;
+        }, Thread::LoopMode::EVENT_DRIVEN));
+
+        Thread urgent("urgent", 3072, LaneCallback::DEFAULT_PRIORITY + 2);
+        TEST_ASSERT_EQUAL(ESP_OK, urgent.start([&]
+        {
+            callback.invoke(Event{esp_timer_get_time(), true}, nullptr, -1, urgentLane);
+            return count.load() < SAMPLES ? Thread::LoopAction::CONTINUE : Thread::LoopAction::STOP;
+        }, 10));
+
+        while (count.load() < SAMPLES) vTaskDelay(pdMS_TO_TICKS(50));
+        flood.stop();
+        urgent.stop();
+
+        std::sort(latency.begin(), latency.end());
+        return latency[(SAMPLES * 99 + 99) / 100 - 1];
+    }
+
+    void test_high_lane_p99_under_saturation()
+    {
+        const int64_t fifo = measureP99(0);
+        const int64_t lanes = measureP99(1);
+        std::printf("urgent p99: same lane %lld us, high lane %lld us\n",
+                    static_cast<long long>(fifo), static_cast<long long>(lanes));
+
+        TEST_ASSERT_TRUE(lanes <= P99_BUDGET_US);
+        TEST_ASSERT_TRUE(lanes * 2 < fifo);
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    // Тест выше рабочих потоков: иначе насыщенный Callback не отдал бы ему процессор
+    vTaskPrioritySet(nullptr, LaneCallback::DEFAULT_PRIORITY + 3);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_high_lane_p99_under_saturation);
+    UNITY_END();
+}
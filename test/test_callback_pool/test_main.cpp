@@ -0,0 +1,148 @@
+// Пропускная способность Callback с пулом рабочих потоков при смеси медленных и быстрых обработчиков.
+// Медленный обработчик блокируется (как запись во flash), поэтому пул масштабируется и на одном ядре.
+
+#include "esp32_c3_objects/callback.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr uint8_t QUEUE_LENGTH = 32;
+    constexpr uint32_t EVENTS = 64;
+    constexpr uint32_t SLOW_EVERY = 4;
+    constexpr uint32_t SLOW_MS = 20;
+    constexpr int64_t FAST_US = 50;
+    constexpr int64_t TIMEOUT_US = 10 * 1000 * 1000;
+
+    struct Job
+    {
+        uint32_t seq = 0;
+        bool slow = false;
+    };
+
+    using PoolCallback = Callback<Job, 0, QUEUE_LENGTH>;
+
+    void spin(const int64_t us)
+    {
+        const int64_t end = esp_timer_get_time() + us;
+        while (esp_timer_get_time() < end) {}
+    }
+
+    void work(const Job& job)
+    {
+        if (job.slow)
+        {
+            vTaskDelay(pdMS_TO_TICKS(SLOW_MS));
+        }
+        else
+        {
+            spin(FAST_US);
+        }
+    }
+
+    /// Обработать EVENTS событий для всех функций и вернуть пропускную способность в событиях/с
+    uint32_t measureThroughput(const uint8_t workers)
+    {
+        std::atomic<uint32_t> done{0};
+
+        PoolCallback callback("pool", QUEUE_LENGTH, 2, PoolCallback::DEFAULT_STACK_DEPTH,
+                              PoolCallback::DEFAULT_PRIORITY, workers);
+        TEST_ASSERT_TRUE(callback.isInitialized());
+        TEST_ASSERT_EQUAL(0, callback.addCallback([&](const Job& job, Job&)
+        {
+            work(job);
+            done.fetch_add(1);
+            return false;
+        }));
+
+        const int64_t start = esp_timer_get_time();
+        for (uint32_t i = 0; i < EVENTS; ++i)
+        {
+            callback.invoke(Job{i, i % SLOW_EVERY == 0});
+        }
+        while (done.load() < EVENTS && esp_timer_get_time() - start < TIMEOUT_US) vTaskDelay(1);
+        const int64_t elapsed = esp_timer_get_time() - start;
+
+        TEST_ASSERT_EQUAL(EVENTS, done.load());
+        return static_cast<uint32_t>(EVENTS * 1000000LL / elapsed);
+    }
+
+    void test_pool_throughput_scales_with_workers()
+    {
+        const uint32_t one = measureThroughput(1);
+        const uint32_t two = measureThroughput(2);
+        const uint32_t four = measureThroughput(4);
+        std::printf("pool throughput: 1 worker %lu ev/s, 2 workers %lu ev/s, 4 workers %lu ev/s\n",
+                    static_cast<unsigned long>(one), static_cast<unsigned long>(two),
+                    static_cast<unsigned long>(four));
+
+        TEST_ASSERT_TRUE(two * 10 > one * 15);
+        TEST_ASSERT_TRUE(four * 10 > one * 25);
+    }
+
+    void test_pool_keeps_per_index_order()
+    {
+        std::atomic<uint32_t> done{0};
+        std::atomic<uint32_t> expected{0};
+        std::atomic<uint32_t> misordered{0};
+
+        PoolCallback callback("pool", QUEUE_LENGTH, 2, PoolCallback::DEFAULT_STACK_DEPTH,
+                              PoolCallback::DEFAULT_PRIORITY, 4);
+        TEST_ASSERT_EQUAL(0, callback.addCallback([&](const Job& job, Job&)
+        {
+            work(job);
+            done.fetch_add(1);
+            return false;
+        }));
+        TEST_ASSERT_EQUAL(1, callback.addCallback([&](const Job& job, Job&)
+        {
+            if (expected.load() != job.seq) misordered.fetch_add(1);
+            expected.store(job.seq + 1);
+            spin(FAST_US);
+            done.fetch_add(1);
+            return false;
+        }, true));
+
+        // Упорядоченный поток индекса 1 перемежается событиями только для общей функции
+        // (она вызывается и для событий индекса 1)
+        const int64_t start = esp_timer_get_time();
+        uint32_t seq = 0;
+        for (uint32_t i = 0; i < EVENTS; ++i)
+        {
+            if (i % 2 == 0)
+            {
+                callback.invoke(Job{seq++, i % SLOW_EVERY == 0}, nullptr, 1);
+            }
+            else
+            {
+                callback.invoke(Job{i, false});
+            }
+        }
+        const uint32_t calls = EVENTS + seq;
+        while (done.load() < calls && esp_timer_get_time() - start < TIMEOUT_US) vTaskDelay(1);
+
+        TEST_ASSERT_EQUAL(calls, done.load());
+        TEST_ASSERT_EQUAL(seq, expected.load());
+        TEST_ASSERT_EQUAL(0, misordered.load());
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_pool_throughput_scales_with_workers);
+    RUN_TEST(test_pool_keeps_per_index_order);
+    UNITY_END();
+}
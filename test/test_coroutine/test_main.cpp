@@ -0,0 +1,370 @@
+// Планирование и отмена сопрограмм CoroutineRuntime, ожидание очередей и таймауты
+
+#include "esp32_c3_objects/coroutine.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr size_t MAX_FLOWS = 4;
+    constexpr size_t FRAME_SIZE = 256;
+
+    using Storage = CoroutineStorage<MAX_FLOWS, FRAME_SIZE>;
+
+    /// Задержка получения элемента значительно меньше периода тика
+    constexpr int64_t MAX_RECEIVE_LATENCY_US = 1000000 / configTICK_RATE_HZ / 10;
+
+    /// Итог ожидания очереди в сопрограмме
+    struct Reception
+    {
+        std::atomic<bool> done{false};     ///< Ожидание завершено
+        std::atomic<bool> received{false}; ///< Элемент получен
+        std::atomic<uint32_t> value{0};    ///< Полученный элемент
+        std::atomic<int64_t> at{0};        ///< Время завершения ожидания
+    };
+
+    /// Объект в кадре сопрограммы, отмечающий своё уничтожение
+    struct Guard
+    {
+        std::atomic<int>& destroyed;
+
+        ~Guard()
+        {
+            destroyed.fetch_add(1);
+        }
+    };
+
+    Coroutine sleeper(CoroutineRuntime& runtime, const uint32_t ms, std::array<int, MAX_FLOWS>& order,
+                      std::atomic<size_t>& position, const int tag)
+    {
+        co_await runtime.delay(ms);
+        order[position.fetch_add(1)] = tag;
+    }
+
+    Coroutine stepper(CoroutineRuntime& runtime, std::array<int, 8>& trace, std::atomic<size_t>& position,
+                      const int tag)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            trace[position.fetch_add(1)] = tag;
+            co_await runtime.yield();
+        }
+    }
+
+    Coroutine listener(CoroutineRuntime& runtime, std::atomic<uint32_t>& received)
+    {
+        received.store(co_await runtime.notified(0x3));
+    }
+
+    Coroutine blocked(CoroutineRuntime& runtime, std::atomic<int>& destroyed, std::atomic<bool>& finished)
+    {
+        Guard guard{destroyed};
+        co_await runtime.delay(60000);
+        finished.store(true);
+    }
+
+    template <typename QueueType>
+    Coroutine receiver(CoroutineRuntime& runtime, QueueType& queue, const TickType_t ticks, Reception& reception)
+    {
+        uint32_t value = 0;
+        const bool received = co_await runtime.receive(queue, value, ticks);
+        reception.at.store(esp_timer_get_time());
+        reception.value.store(value);
+        reception.received.store(received);
+        reception.done.store(true);
+    }
+
+    Coroutine timedListener(CoroutineRuntime& runtime, const TickType_t ticks, std::atomic<uint32_t>& received,
+                            std::atomic<bool>& done)
+    {
+        received.store(co_await runtime.notified(0x1, ticks));
+        done.store(true);
+    }
+
+    /// Отправка в середине тика: опрос раз в тик дал бы задержку в несколько миллисекунд
+    template <typename QueueType>
+    int64_t sendBetweenTicks(QueueType& queue, const uint32_t value)
+    {
+        vTaskDelay(1);
+        const int64_t tickStart = esp_timer_get_time();
+        while (esp_timer_get_time() - tickStart < 1000000 / configTICK_RATE_HZ / 3) {}
+
+        const int64_t sentAt = esp_timer_get_time();
+        TEST_ASSERT_TRUE(queue.send(value, 0));
+        return sentAt;
+    }
+
+    /// Дождаться завершения всех сопрограмм исполнителя
+    bool settle(const CoroutineRuntime& runtime, const TickType_t timeout = pdMS_TO_TICKS(1000))
+    {
+        const TickType_t start = xTaskGetTickCount();
+        while (runtime.activeFlows() > 0)
+        {
+            if (xTaskGetTickCount() - start > timeout) return false;
+            vTaskDelay(1);
+        }
+        return true;
+    }
+
+    void test_delays_resume_in_deadline_order()
+    {
+        Storage storage;
+        CoroutineRuntime runtime("coro", storage);
+        TEST_ASSERT_TRUE(runtime.start());
+
+        std::array<int, MAX_FLOWS> order{};
+        std::atomic<size_t> position{0};
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW, runtime.spawn(sleeper(runtime, 60, order, position, 3)));
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW, runtime.spawn(sleeper(runtime, 20, order, position, 1)));
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW, runtime.spawn(sleeper(runtime, 40, order, position, 2)));
+
+        TEST_ASSERT_TRUE(settle(runtime));
+        TEST_ASSERT_EQUAL(3, position.load());
+        TEST_ASSERT_EQUAL(1, order[0]);
+        TEST_ASSERT_EQUAL(2, order[1]);
+        TEST_ASSERT_EQUAL(3, order[2]);
+    }
+
+    void test_yield_alternates_flows()
+    {
+        Storage storage;
+        CoroutineRuntime runtime("coro", storage);
+
+        std::array<int, 8> trace{};
+        std::atomic<size_t> position{0};
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW, runtime.spawn(stepper(runtime, trace, position, 1)));
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW, runtime.spawn(stepper(runtime, trace, position, 2)));
+        TEST_ASSERT_TRUE(runtime.start());
+
+        TEST_ASSERT_TRUE(settle(runtime));
+        TEST_ASSERT_EQUAL(8, position.load());
+        for (size_t i = 0; i < trace.size(); ++i)
+        {
+            TEST_ASSERT_EQUAL(i % 2 == 0 ? 1 : 2, trace[i]);
+        }
+    }
+
+    void test_notify_wakes_listener()
+    {
+        Storage storage;
+        CoroutineRuntime runtime("coro", storage);
+        TEST_ASSERT_TRUE(runtime.start());
+
+        std::atomic<uint32_t> received{0};
+        const CoroutineRuntime::FlowId id = runtime.spawn(listener(runtime, received));
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW, id);
+
+        vTaskDelay(pdMS_TO_TICKS(30));
+        TEST_ASSERT_TRUE(runtime.isAlive(id));
+
+        runtime.notify(0x6);
+        TEST_ASSERT_TRUE(settle(runtime));
+        TEST_ASSERT_EQUAL_UINT32(0x2, received.load());
+    }
+
+    void test_cancel_destroys_frame_and_frees_slot()
+    {
+        Storage storage;
+        CoroutineRuntime runtime("coro", storage);
+        TEST_ASSERT_TRUE(runtime.start());
+
+        std::atomic<int> destroyed{0};
+        std::atomic<bool> finished{false};
+        const CoroutineRuntime::FlowId id = runtime.spawn(blocked(runtime, destroyed, finished));
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW, id);
+        vTaskDelay(pdMS_TO_TICKS(20));
+
+        TEST_ASSERT_TRUE(runtime.cancel(id));
+        TEST_ASSERT_TRUE(settle(runtime));
+        TEST_ASSERT_EQUAL(1, destroyed.load());
+        TEST_ASSERT_FALSE(finished.load());
+        TEST_ASSERT_FALSE(runtime.cancel(id));
+
+        // Все слоты пула снова свободны
+        std::array<Coroutine, MAX_FLOWS> flows;
+        for (Coroutine& flow : flows)
+        {
+            flow = blocked(runtime, destroyed, finished);
+            TEST_ASSERT_TRUE(static_cast<bool>(flow));
+        }
+    }
+
+    void test_foreign_frame_rejected()
+    {
+        Storage storage;
+        Storage otherStorage;
+        CoroutineRuntime runtime("coro", storage);
+        CoroutineRuntime other("other", otherStorage);
+
+        std::atomic<int> destroyed{0};
+        std::atomic<bool> finished{false};
+        Coroutine flow = blocked(other, destroyed, finished);
+        TEST_ASSERT_TRUE(static_cast<bool>(flow));
+
+        TEST_ASSERT_EQUAL(CoroutineRuntime::INVALID_FLOW, runtime.spawn(std::move(flow)));
+        TEST_ASSERT_TRUE(static_cast<bool>(flow));
+        TEST_ASSERT_EQUAL(0, runtime.activeFlows());
+    }
+
+    template <typename QueueType>
+    void receiveWakesOnSend(QueueType& queue)
+    {
+        Storage storage;
+        CoroutineRuntime runtime("coro", storage);
+        TEST_ASSERT_TRUE(runtime.start());
+
+        Reception reception;
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW,
+                              runtime.spawn(receiver(runtime, queue, portMAX_DELAY, reception)));
+        vTaskDelay(pdMS_TO_TICKS(30));
+        TEST_ASSERT_FALSE(reception.done.load());
+
+        const int64_t sentAt = sendBetweenTicks(queue, 42);
+        TEST_ASSERT_TRUE(settle(runtime));
+        TEST_ASSERT_TRUE(reception.received.load());
+        TEST_ASSERT_EQUAL_UINT32(42, reception.value.load());
+        TEST_ASSERT_TRUE(reception.at.load() - sentAt < MAX_RECEIVE_LATENCY_US);
+
+        // Очередь больше никто не ожидает, и обработчик отправки исполнителя снят
+        const QueueSendHook other{[](void*) noexcept {}, [](void*, BaseType_t&) noexcept {}, nullptr};
+        TEST_ASSERT_TRUE(queue.attachSendHook(other));
+        queue.detachSendHook(other);
+    }
+
+    void test_queue_receive_wakes_on_send()
+    {
+        Queue<uint32_t> queue(4);
+        receiveWakesOnSend(queue);
+    }
+
+    void test_buffered_queue_receive_wakes_on_send()
+    {
+        BufferedQueue<uint32_t, 4> queue(4);
+        receiveWakesOnSend(queue);
+    }
+
+    void test_shared_queue_keeps_waking_remaining_flow()
+    {
+        Storage storage;
+        CoroutineRuntime runtime("coro", storage);
+        TEST_ASSERT_TRUE(runtime.start());
+
+        Queue<uint32_t> queue(4);
+        Reception first;
+        Reception second;
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW,
+                              runtime.spawn(receiver(runtime, queue, portMAX_DELAY, first)));
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW,
+                              runtime.spawn(receiver(runtime, queue, portMAX_DELAY, second)));
+        vTaskDelay(pdMS_TO_TICKS(30));
+
+        // Первая завершившаяся сопрограмма не снимает обработчик, пока очередь ждёт вторая
+        sendBetweenTicks(queue, 1);
+        for (int i = 0; i < 100 && !first.done.load() && !second.done.load(); ++i) vTaskDelay(1);
+        TEST_ASSERT_EQUAL(1, runtime.activeFlows());
+
+        const int64_t sentAt = sendBetweenTicks(queue, 2);
+        TEST_ASSERT_TRUE(settle(runtime));
+        TEST_ASSERT_TRUE(first.received.load() && second.received.load());
+        TEST_ASSERT_EQUAL_UINT32(3, first.value.load() + second.value.load());
+        TEST_ASSERT_TRUE(std::max(first.at.load(), second.at.load()) - sentAt < MAX_RECEIVE_LATENCY_US);
+    }
+
+    void test_receive_times_out()
+    {
+        Storage storage;
+        CoroutineRuntime runtime("coro", storage);
+        TEST_ASSERT_TRUE(runtime.start());
+
+        Queue<uint32_t> queue(4);
+        BufferedQueue<uint32_t, 4> buffered(4);
+        Reception plain;
+        Reception bufferedReception;
+        const int64_t start = esp_timer_get_time();
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW,
+                              runtime.spawn(receiver(runtime, queue, pdMS_TO_TICKS(50), plain)));
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW,
+                              runtime.spawn(receiver(runtime, buffered, pdMS_TO_TICKS(50), bufferedReception)));
+
+        TEST_ASSERT_TRUE(settle(runtime));
+        TEST_ASSERT_FALSE(plain.received.load());
+        TEST_ASSERT_FALSE(bufferedReception.received.load());
+        TEST_ASSERT_TRUE(plain.at.load() - start >= 40 * 1000);
+        TEST_ASSERT_TRUE(bufferedReception.at.load() - start >= 40 * 1000);
+
+        // Элемент, отправленный после таймаута, остаётся в очереди
+        TEST_ASSERT_TRUE(queue.send(7, 0));
+        TEST_ASSERT_EQUAL(1, queue.messagesWaiting());
+    }
+
+    void test_notified_times_out()
+    {
+        Storage storage;
+        CoroutineRuntime runtime("coro", storage);
+        TEST_ASSERT_TRUE(runtime.start());
+
+        std::atomic<uint32_t> received{0xFF};
+        std::atomic<bool> done{false};
+        TEST_ASSERT_NOT_EQUAL(CoroutineRuntime::INVALID_FLOW,
+                              runtime.spawn(timedListener(runtime, pdMS_TO_TICKS(30), received, done)));
+
+        // Биты вне маски не завершают ожидание
+        runtime.notify(0x2);
+        TEST_ASSERT_TRUE(settle(runtime));
+        TEST_ASSERT_TRUE(done.load());
+        TEST_ASSERT_EQUAL_UINT32(0, received.load());
+    }
+
+    void test_runtime_destroys_unspawned_frames()
+    {
+        std::atomic<int> destroyed{0};
+        std::atomic<bool> finished{false};
+        Coroutine pending;
+        Coroutine moved;
+        {
+            Storage storage;
+            CoroutineRuntime runtime("coro", storage);
+            pending = blocked(runtime, destroyed, finished);
+            Coroutine temporary = blocked(runtime, destroyed, finished);
+            moved = std::move(temporary);
+            TEST_ASSERT_TRUE(static_cast<bool>(pending));
+            TEST_ASSERT_TRUE(static_cast<bool>(moved));
+        }
+
+        // Кадры не начинали выполняться, поэтому Guard в них ещё не создан
+        TEST_ASSERT_FALSE(static_cast<bool>(pending));
+        TEST_ASSERT_FALSE(static_cast<bool>(moved));
+        TEST_ASSERT_EQUAL(0, destroyed.load());
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_delays_resume_in_deadline_order);
+    RUN_TEST(test_yield_alternates_flows);
+    RUN_TEST(test_notify_wakes_listener);
+    RUN_TEST(test_cancel_destroys_frame_and_frees_slot);
+    RUN_TEST(test_foreign_frame_rejected);
+    RUN_TEST(test_runtime_destroys_unspawned_frames);
+    RUN_TEST(test_queue_receive_wakes_on_send);
+    RUN_TEST(test_buffered_queue_receive_wakes_on_send);
+    RUN_TEST(test_shared_queue_keeps_waking_remaining_flow);
+    RUN_TEST(test_receive_times_out);
+    RUN_TEST(test_notified_times_out);
+    UNITY_END();
+}
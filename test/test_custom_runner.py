@@ -0,0 +1,57 @@
+"""
+Запуск наборов тестов на цели linux ESP-IDF (FreeRTOS на POSIX): pio test -e linux.
+
+PlatformIO не собирает ESP-IDF для цели linux, поэтому каждый набор собирается проектом
+test/host через idf.py, а полученная программа запускается как native-программа окружения.
+Вывод разбирается обычным Unity-обработчиком PlatformIO.
+Требуется ESP-IDF 5.4 с установленным окружением (IDF_PATH, idf.py в PATH).
+"""
+
+import os
+import shutil
+import subprocess
+
+import click
+
+from platformio.public import UnityTestRunner
+from platformio.test.exception import UnitTestSuiteError
+
+
+class CustomTestRunner(UnityTestRunner):
+    def stage_building(self):
+        if self.options.without_building:
+            return None
+
+        click.secho("Building for the IDF linux target...", bold=self.options.verbose)
+
+        suite = self.test_suite.test_name
+        project_dir = os.path.dirname(self.project_config.path)
+        env_build_dir = os.path.join(
+            self.project_config.get("platformio", "build_dir"), self.test_suite.env_name
+        )
+        suite_build_dir = os.path.join(env_build_dir, "idf", suite)
+
+        command = [
+            "idf.py",
+            "--preview",
+            "-C", os.path.join(project_dir, "test", "host"),
+            "-B", suite_build_dir,
+            "-DIDF_TARGET=linux",
+            "-DSDKCONFIG=" + os.path.join(suite_build_dir, "sdkconfig"),
+            "-DTEST_SUITE=" + suite,
+            "build",
+        ]
+        result = subprocess.run(
+            command, check=False, capture_output=not self.options.verbose, text=True
+        )
+        if result.returncode != 0:
+            if not self.options.verbose:
+                click.echo(result.stdout + result.stderr)
+            raise UnitTestSuiteError("Building %s for the linux target failed" % suite)
+
+        # Программа размещается там, где её ищет запуск native-тестов PlatformIO
+        shutil.copy(
+            os.path.join(suite_build_dir, "host_test.elf"),
+            os.path.join(env_build_dir, "program"),
+        )
+        return None
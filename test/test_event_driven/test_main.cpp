@@ -0,0 +1,115 @@
+// Пропускная способность и задержка диспетчеризации в режиме EVENT_DRIVEN.
+// При CONFIG_FREERTOS_HZ=100 прежняя задержка на тик после каждой итерации ограничивала
+// обработку сотней событий в секунду и задержкой до 10 мс.
+
+#include "esp32_c3_objects/callback.h"
+#include "esp32_c3_objects/thread.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr uint32_t EVENTS = 1000;
+    constexpr size_t SAMPLES = 100;
+    constexpr int64_t TIMEOUT_US = 10 * 1000 * 1000;
+
+    /// Событий в секунду, недостижимых при задержке на тик после каждого события
+    constexpr uint32_t MIN_EVENTS_PER_SECOND = 10 * configTICK_RATE_HZ;
+
+    /// Задержка значительно меньше периода тика
+    constexpr int64_t MAX_MEDIAN_LATENCY_US = 1000000 / configTICK_RATE_HZ / 10;
+
+    void test_event_driven_thread_throughput()
+    {
+        const QueueHandle_t queue = xQueueCreate(16, sizeof(uint32_t));
+        TEST_ASSERT_NOT_NULL(queue);
+
+        std::atomic<uint32_t> received{0};
+        Thread thread("events", 3072, 5);
+        TEST_ASSERT_EQUAL(ESP_OK, thread.startEventDriven([&]
+        {
+            uint32_t value;
+            if (xQueueReceive(queue, &value, pdMS_TO_TICKS(100)) == pdTRUE) received.fetch_add(1);
+            return Thread::LoopAction::CONTINUE;
+        }));
+
+        const int64_t start = esp_timer_get_time();
+        for (uint32_t i = 0; i < EVENTS; ++i)
+        {
+            TEST_ASSERT_EQUAL(pdTRUE, xQueueSend(queue, &i, portMAX_DELAY));
+        }
+        while (received.load() < EVENTS && esp_timer_get_time() - start < TIMEOUT_US) vTaskDelay(1);
+        const int64_t elapsed = esp_timer_get_time() - start;
+        thread.stop();
+        vQueueDelete(queue);
+
+        const auto rate = static_cast<uint32_t>(EVENTS * 1000000LL / elapsed);
+        std::printf("event-driven Thread: %lu ev/s\n", static_cast<unsigned long>(rate));
+        TEST_ASSERT_EQUAL(EVENTS, received.load());
+        TEST_ASSERT_TRUE(rate > MIN_EVENTS_PER_SECOND);
+    }
+
+    void test_callback_throughput_and_latency()
+    {
+        std::atomic<uint32_t> handled{0};
+        std::atomic<int64_t> lastLatency{0};
+
+        Callback<int64_t> callback("events");
+        TEST_ASSERT_EQUAL(0, callback.addCallback([&](const int64_t& stamp, int64_t&)
+        {
+            lastLatency.store(esp_timer_get_time() - stamp);
+            handled.fetch_add(1);
+            return false;
+        }));
+
+        // Пропускная способность: события отправляются подряд
+        const int64_t start = esp_timer_get_time();
+        for (uint32_t i = 0; i < EVENTS; ++i)
+        {
+            callback.invoke(esp_timer_get_time());
+        }
+        while (handled.load() < EVENTS && esp_timer_get_time() - start < TIMEOUT_US) vTaskDelay(1);
+        const int64_t elapsed = esp_timer_get_time() - start;
+        TEST_ASSERT_EQUAL(EVENTS, handled.load());
+
+        // Задержка: каждое событие отправляется после обработки предыдущего
+        std::array<int64_t, SAMPLES> latency{};
+        for (auto& sample : latency)
+        {
+            const uint32_t before = handled.load();
+            callback.invoke(esp_timer_get_time());
+            while (handled.load() == before) vTaskDelay(1);
+            sample = lastLatency.load();
+        }
+        std::sort(latency.begin(), latency.end());
+
+        const auto rate = static_cast<uint32_t>(EVENTS * 1000000LL / elapsed);
+        std::printf("Callback: %lu ev/s, latency median %lld us, max %lld us\n", static_cast<unsigned long>(rate),
+                    static_cast<long long>(latency[SAMPLES / 2]), static_cast<long long>(latency.back()));
+        TEST_ASSERT_TRUE(rate > MIN_EVENTS_PER_SECOND);
+        TEST_ASSERT_TRUE(latency[SAMPLES / 2] < MAX_MEDIAN_LATENCY_US);
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_event_driven_thread_throughput);
+    RUN_TEST(test_callback_throughput_and_latency);
+    UNITY_END();
+}
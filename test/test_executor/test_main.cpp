@@ -0,0 +1,138 @@
+// Задержка от постановки задания Executor до начала его выполнения в сравнении с созданием Thread
+// на каждое задание, а также остановка исполнителя.
+
+#include "esp32_c3_objects/executor.h"
+#include "esp32_c3_objects/thread.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr size_t SAMPLES = 50;
+    constexpr UBaseType_t WORKER_PRIORITY = 10;
+    constexpr int64_t STOP_BUDGET_US = 500 * 1000;
+
+    using TestExecutor = Executor<2, 8>;
+
+    int64_t median(std::array<int64_t, SAMPLES>& samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        return samples[SAMPLES / 2];
+    }
+
+    /// Задержка начала задания, поставленного в работающий исполнитель
+    int64_t measureExecutor()
+    {
+        TestExecutor executor("exec", TestExecutor::DEFAULT_STACK_DEPTH, WORKER_PRIORITY);
+
+        // Первая постановка создаёт рабочие потоки и в измерение не входит
+        Completion warmup;
+        TEST_ASSERT_TRUE(executor.submit([] {}, warmup));
+        TEST_ASSERT_TRUE(warmup.wait());
+
+        std::array<int64_t, SAMPLES> latency{};
+        for (auto& sample : latency)
+        {
+            int64_t started = 0;
+            Completion completion;
+            const int64_t submitted = esp_timer_get_time();
+            TEST_ASSERT_TRUE(executor.submit([&started] { started = esp_timer_get_time(); }, completion));
+            TEST_ASSERT_TRUE(completion.wait());
+            sample = started - submitted;
+        }
+        return median(latency);
+    }
+
+    /// Задержка начала задания в отдельно созданном Thread
+    int64_t measureThreadSpawn()
+    {
+        std::array<int64_t, SAMPLES> latency{};
+        for (auto& sample : latency)
+        {
+            std::atomic<int64_t> started{0};
+            const int64_t submitted = esp_timer_get_time();
+            Thread thread("job", TestExecutor::DEFAULT_STACK_DEPTH, WORKER_PRIORITY);
+            TEST_ASSERT_TRUE(thread.quickStart([&started]
+            {
+                started.store(esp_timer_get_time());
+                return Thread::LoopAction::STOP;
+            }, Thread::LoopMode::EVENT_DRIVEN));
+            while (started.load() == 0) vTaskDelay(1);
+            thread.stop();
+            sample = started.load() - submitted;
+        }
+        return median(latency);
+    }
+
+    void test_submit_to_start_latency()
+    {
+        const int64_t executor = measureExecutor();
+        const int64_t spawn = measureThreadSpawn();
+        std::printf("submit-to-start median: executor %lld us, new Thread %lld us\n",
+                    static_cast<long long>(executor), static_cast<long long>(spawn));
+
+        TEST_ASSERT_TRUE(executor < spawn);
+    }
+
+    void test_shutdown_stops_all_workers()
+    {
+        Executor<4, 8> executor("exec", TestExecutor::DEFAULT_STACK_DEPTH, WORKER_PRIORITY);
+        for (int round = 0; round < 5; ++round)
+        {
+            std::atomic<int> done{0};
+            for (int i = 0; i < 8; ++i)
+            {
+                TEST_ASSERT_TRUE(executor.submit([&done] { done.fetch_add(1); }));
+            }
+
+            // Без принудительного удаления потоков остановка укладывается в доли STOP_TIMEOUT_MS
+            const int64_t start = esp_timer_get_time();
+            executor.shutdown();
+            TEST_ASSERT_TRUE(esp_timer_get_time() - start < STOP_BUDGET_US);
+            TEST_ASSERT_EQUAL(8, done.load());
+        }
+    }
+
+    void test_shutdown_from_job_is_ignored()
+    {
+        TestExecutor executor("exec", TestExecutor::DEFAULT_STACK_DEPTH, WORKER_PRIORITY);
+
+        std::atomic<bool> returned{false};
+        Completion completion;
+        TEST_ASSERT_TRUE(executor.submit([&]
+        {
+            executor.shutdown();
+            returned.store(true);
+        }, completion));
+        TEST_ASSERT_TRUE(completion.wait(pdMS_TO_TICKS(1000)));
+        TEST_ASSERT_TRUE(returned.load());
+
+        // Исполнитель продолжает работать
+        Completion next;
+        TEST_ASSERT_TRUE(executor.submit([] {}, next));
+        TEST_ASSERT_TRUE(next.wait(pdMS_TO_TICKS(1000)));
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_submit_to_start_latency);
+    RUN_TEST(test_shutdown_stops_all_workers);
+    RUN_TEST(test_shutdown_from_job_is_ignored);
+    UNITY_END();
+}
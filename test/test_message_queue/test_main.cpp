@@ -0,0 +1,85 @@
+// Переход записи в начало кольцевого буфера MessageQueue при одновременной работе отправителя:
+// полученное сообщение не должно перезаписываться до release().
+
+#include "esp32_c3_objects/message_queue.h"
+#include "esp32_c3_objects/thread.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr uint32_t MESSAGES = 20000;
+
+    using TestQueue = MessageQueue<uint32_t, 128>;
+
+    /// Запись из 40 байт: три записи оставляют в конце буфера пропуск, и полный буфер регулярно
+    /// оказывается в состоянии, когда позиции чтения и записи совпадают на маркере перехода
+    constexpr size_t PAYLOAD = 32;
+
+    uint8_t payloadByte(const uint32_t seq, const size_t i)
+    {
+        return static_cast<uint8_t>(seq * 31 + i);
+    }
+
+    void test_wrap_with_concurrent_writer()
+    {
+        TestQueue queue;
+        TEST_ASSERT_TRUE(queue.isValid());
+
+        std::atomic<bool> sent{false};
+        Thread writer("writer", 3072, 5);
+        TEST_ASSERT_TRUE(writer.quickStart([&]
+        {
+            std::array<uint8_t, PAYLOAD> payload{};
+            for (uint32_t seq = 0; seq < MESSAGES; ++seq)
+            {
+                for (size_t i = 0; i < PAYLOAD; ++i) payload[i] = payloadByte(seq, i);
+                queue.send(seq, payload);
+            }
+            sent.store(true);
+            return Thread::LoopAction::STOP;
+        }, Thread::LoopMode::EVENT_DRIVEN));
+
+        uint32_t corrupted = 0;
+        TestQueue::Message message;
+        for (uint32_t seq = 0; seq < MESSAGES; ++seq)
+        {
+            TEST_ASSERT_EQUAL(QueueReceiveResult::SUCCESS, queue.receive(message, pdMS_TO_TICKS(1000)));
+            TEST_ASSERT_EQUAL(seq, *message.header);
+            TEST_ASSERT_EQUAL(PAYLOAD, message.payload.size());
+
+            // Сообщение проверяется после паузы, в которую отправитель заполняет освободившееся место
+            taskYIELD();
+            for (size_t i = 0; i < message.payload.size(); ++i)
+            {
+                if (message.payload[i] != payloadByte(seq, i) || *message.header != seq) ++corrupted;
+            }
+        }
+        queue.release();
+
+        while (!sent.load()) vTaskDelay(1);
+        writer.stop();
+
+        TEST_ASSERT_EQUAL(0, corrupted);
+        TEST_ASSERT_EQUAL(0, queue.messagesWaiting());
+        TEST_ASSERT_EQUAL(128, queue.bytesAvailable());
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_wrap_with_concurrent_writer);
+    UNITY_END();
+}
@@ -0,0 +1,170 @@
+// Пакетная отправка: потребитель с более высоким приоритетом просыпается один раз на пачку,
+// а не на каждый элемент.
+
+#include "esp32_c3_objects/buffered_queue.h"
+#include "esp32_c3_objects/queue.h"
+#include "esp32_c3_objects/thread.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    constexpr size_t BATCH = 16;
+    constexpr UBaseType_t CONSUMER_PRIORITY = 10;
+
+    /// Итог приёма пачки
+    struct Wakeups
+    {
+        std::atomic<uint32_t> count{0};    ///< Пробуждений потребителя
+        std::atomic<uint32_t> received{0}; ///< Получено элементов
+        std::atomic<bool> ordered{true};   ///< Элементы пришли по порядку
+    };
+
+    std::array<uint32_t, BATCH> makeBatch()
+    {
+        std::array<uint32_t, BATCH> items{};
+        for (uint32_t i = 0; i < BATCH; ++i) items[i] = i;
+        return items;
+    }
+
+    /// Дождаться приёма пачки потребителем
+    void waitBatch(const Wakeups& wakeups)
+    {
+        for (int i = 0; i < 100 && wakeups.received.load() < BATCH; ++i) vTaskDelay(pdMS_TO_TICKS(10));
+        TEST_ASSERT_EQUAL(BATCH, wakeups.received.load());
+        TEST_ASSERT_TRUE(wakeups.ordered.load());
+    }
+
+    void test_queue_batch_wakes_consumer_once()
+    {
+        Queue<uint32_t> queue(BATCH * 2);
+        Wakeups wakeups;
+
+        Thread consumer("consumer", 3072, CONSUMER_PRIORITY);
+        TEST_ASSERT_EQUAL(ESP_OK, consumer.startEventDriven([&]
+        {
+            std::array<uint32_t, BATCH> items{};
+            const size_t received = queue.receiveBatch(items, 1, pdMS_TO_TICKS(100));
+            if (received == 0) return Thread::LoopAction::CONTINUE;
+
+            for (size_t i = 0; i < received; ++i)
+            {
+                if (items[i] != wakeups.received.load() + i) wakeups.ordered.store(false);
+            }
+            wakeups.received.fetch_add(received);
+            wakeups.count.fetch_add(1);
+            return Thread::LoopAction::CONTINUE;
+        }));
+        vTaskDelay(pdMS_TO_TICKS(20));
+
+        const auto items = makeBatch();
+        TEST_ASSERT_EQUAL(BATCH, queue.sendBatch(items));
+        waitBatch(wakeups);
+        consumer.stop();
+
+        TEST_ASSERT_EQUAL(1, wakeups.count.load());
+    }
+
+    void test_buffered_queue_batch_wakes_consumer_once()
+    {
+        BufferedQueue<uint32_t, BATCH * 2> queue(BATCH * 2);
+        Wakeups wakeups;
+
+        Thread consumer("consumer", 3072, CONSUMER_PRIORITY);
+        TEST_ASSERT_EQUAL(ESP_OK, consumer.startEventDriven([&]
+        {
+            std::array<uint32_t, BATCH> items{};
+            const size_t received = queue.receiveBatch(items, 1, pdMS_TO_TICKS(100));
+            if (received == 0) return Thread::LoopAction::CONTINUE;
+
+            for (size_t i = 0; i < received; ++i)
+            {
+                if (items[i] != wakeups.received.load() + i) wakeups.ordered.store(false);
+            }
+            wakeups.received.fetch_add(received);
+            wakeups.count.fetch_add(1);
+            return Thread::LoopAction::CONTINUE;
+        }));
+        vTaskDelay(pdMS_TO_TICKS(20));
+
+        const auto items = makeBatch();
+        TEST_ASSERT_EQUAL(BATCH, queue.sendBatch(items));
+        waitBatch(wakeups);
+        consumer.stop();
+
+        TEST_ASSERT_EQUAL(1, wakeups.count.load());
+    }
+
+    void test_buffered_queue_batch_larger_than_buffer()
+    {
+        // Пачка больше буфера: собранные элементы публикуются до ожидания свободного слота
+        BufferedQueue<uint32_t, 4> queue(4);
+        std::atomic<uint32_t> received{0};
+        std::atomic<bool> ordered{true};
+
+        Thread consumer("consumer", 3072, CONSUMER_PRIORITY);
+        TEST_ASSERT_EQUAL(ESP_OK, consumer.startEventDriven([&]
+        {
+            uint32_t item;
+            if (queue.receive(item, pdMS_TO_TICKS(100)))
+            {
+                if (item != received.load()) ordered.store(false);
+                received.fetch_add(1);
+            }
+            return Thread::LoopAction::CONTINUE;
+        }));
+
+        const auto items = makeBatch();
+        TEST_ASSERT_EQUAL(BATCH, queue.sendBatch(items, pdMS_TO_TICKS(1000)));
+        for (int i = 0; i < 100 && received.load() < BATCH; ++i) vTaskDelay(pdMS_TO_TICKS(10));
+        consumer.stop();
+
+        TEST_ASSERT_EQUAL(BATCH, received.load());
+        TEST_ASSERT_TRUE(ordered.load());
+    }
+
+    void test_queue_batch_calls_send_hook_once()
+    {
+        // Обработчик отправки не вызывается в критической секции: один вызов на пачку
+        Queue<uint32_t> queue(BATCH * 2);
+        std::atomic<uint32_t> calls{0};
+        const QueueSendHook hook{
+            [](void* context) noexcept { static_cast<std::atomic<uint32_t>*>(context)->fetch_add(1); },
+            [](void* context, BaseType_t&) noexcept { static_cast<std::atomic<uint32_t>*>(context)->fetch_add(1); },
+            &calls};
+        TEST_ASSERT_TRUE(queue.attachSendHook(hook));
+
+        const auto items = makeBatch();
+        TEST_ASSERT_EQUAL(BATCH, queue.sendBatch(items));
+        TEST_ASSERT_EQUAL(1, calls.load());
+        TEST_ASSERT_EQUAL(BATCH, queue.messagesWaiting());
+
+        // Очередь заполнена частично: без ожидания отправляется только то, что поместилось
+        TEST_ASSERT_EQUAL(BATCH, queue.sendBatch(items));
+        TEST_ASSERT_EQUAL(0, queue.sendBatch(items));
+        TEST_ASSERT_EQUAL(2, calls.load());
+
+        queue.detachSendHook(hook);
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_queue_batch_wakes_consumer_once);
+    RUN_TEST(test_buffered_queue_batch_wakes_consumer_once);
+    RUN_TEST(test_buffered_queue_batch_larger_than_buffer);
+    RUN_TEST(test_queue_batch_calls_send_hook_once);
+    UNITY_END();
+}
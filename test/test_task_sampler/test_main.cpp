@@ -0,0 +1,130 @@
+// Частота переключений контекста в замерах TaskSampler.
+// Счётчик переключений подменяется тестовым, поэтому ожидаемое приращение известно точно,
+// а частота проверяется относительно интервала между замерами в тиках.
+
+#include "esp32_c3_objects/task_sampler.h"
+
+#include <atomic>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unity.h>
+
+using namespace esp32_c3::objects;
+
+namespace
+{
+    using Sampler = TaskSampler<32, 4>;
+
+    constexpr uint32_t SWITCHES = 250;
+    constexpr uint32_t INTERVAL_MS = 500;
+
+    std::atomic<uint32_t> gSwitches{0};
+
+    uint32_t switchCount() noexcept
+    {
+        return gSwitches.load();
+    }
+
+    void test_switch_rate_from_counter()
+    {
+        Sampler sampler("sampler");
+        TEST_ASSERT_TRUE(sampler.isInitialized());
+
+        gSwitches.store(1000);
+        sampler.setSwitchCounter(switchCount);
+        TEST_ASSERT_TRUE(sampler.sample());
+
+        // Переключения до setSwitchCounter() не попадают в первый замер
+        Sampler::Snapshot first;
+        TEST_ASSERT_TRUE(sampler.history(first));
+        TEST_ASSERT_EQUAL_UINT32(0, first.switches);
+
+        gSwitches.fetch_add(SWITCHES);
+        vTaskDelay(pdMS_TO_TICKS(INTERVAL_MS));
+        TEST_ASSERT_TRUE(sampler.sample());
+
+        Sampler::Snapshot second;
+        TEST_ASSERT_TRUE(sampler.history(second));
+        TEST_ASSERT_EQUAL_UINT32(SWITCHES, second.switches);
+
+        const TickType_t elapsed = second.timestamp - first.timestamp;
+        TEST_ASSERT_GREATER_OR_EQUAL(pdMS_TO_TICKS(INTERVAL_MS), elapsed);
+        TEST_ASSERT_EQUAL_UINT32(SWITCHES * configTICK_RATE_HZ / elapsed, second.switchesPerSecond);
+        TEST_ASSERT_UINT32_WITHIN(SWITCHES * 1000 / INTERVAL_MS / 5, SWITCHES * 1000 / INTERVAL_MS,
+                                  second.switchesPerSecond);
+    }
+
+    void test_switch_counter_wraps()
+    {
+        Sampler sampler("sampler");
+
+        gSwitches.store(UINT32_MAX - 10);
+        sampler.setSwitchCounter(switchCount);
+        TEST_ASSERT_TRUE(sampler.sample());
+
+        gSwitches.fetch_add(30);
+        vTaskDelay(pdMS_TO_TICKS(100));
+        TEST_ASSERT_TRUE(sampler.sample());
+
+        Sampler::Snapshot snapshot;
+        TEST_ASSERT_TRUE(sampler.history(snapshot));
+        TEST_ASSERT_EQUAL_UINT32(30, snapshot.switches);
+    }
+
+    void test_no_counter_reports_zero()
+    {
+        Sampler sampler("sampler");
+
+        gSwitches.store(0);
+        sampler.setSwitchCounter(switchCount);
+        sampler.setSwitchCounter(nullptr);
+        gSwitches.fetch_add(SWITCHES);
+
+        TEST_ASSERT_TRUE(sampler.sample());
+        vTaskDelay(pdMS_TO_TICKS(100));
+        TEST_ASSERT_TRUE(sampler.sample());
+
+        Sampler::Snapshot snapshot;
+        TEST_ASSERT_TRUE(sampler.history(snapshot));
+        TEST_ASSERT_EQUAL_UINT32(0, snapshot.switches);
+        TEST_ASSERT_EQUAL_UINT32(0, snapshot.switchesPerSecond);
+    }
+
+    void test_periodic_samples_carry_rate()
+    {
+        Sampler sampler("sampler");
+
+        gSwitches.store(0);
+        sampler.setSwitchCounter(switchCount);
+        TEST_ASSERT_TRUE(sampler.start(100));
+
+        // Равномерный поток переключений: 10 за тик
+        for (int i = 0; i < 50; ++i)
+        {
+            gSwitches.fetch_add(10);
+            vTaskDelay(1);
+        }
+        sampler.stop();
+
+        TEST_ASSERT_GREATER_OR_EQUAL(3, sampler.samples());
+        Sampler::Snapshot snapshot;
+        TEST_ASSERT_TRUE(sampler.history(snapshot, 1));
+        TEST_ASSERT_GREATER_THAN_UINT32(0, snapshot.switches);
+        TEST_ASSERT_UINT32_WITHIN(configTICK_RATE_HZ * 10 / 2, configTICK_RATE_HZ * 10, snapshot.switchesPerSecond);
+    }
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+extern "C" void app_main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_switch_rate_from_counter);
+    RUN_TEST(test_switch_counter_wraps);
+    RUN_TEST(test_no_counter_reports_zero);
+    RUN_TEST(test_periodic_samples_carry_rate);
+    UNITY_END();
+}